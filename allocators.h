@@ -0,0 +1,699 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if __has_include(<malloc.h>)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>
+#endif
+
+// Result of allocate_at_least: the block and the number of elements it can really hold
+template <typename Pointer>
+struct AllocationResult
+{
+    Pointer ptr;
+    size_t count;
+};
+
+//--------------------------------------------------------------------MallocAllocator------------------------------------------------------
+// malloc/free based allocator with a reallocate hook, which lets Vector grow trivially relocatable elements with realloc
+// (in place whenever the C heap can extend the block)
+
+template <typename T>
+class MallocAllocator
+{
+public:
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not guarantee over-aligned storage");
+
+    using value_type = T;
+
+    MallocAllocator() noexcept = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n_)
+    {
+        if (n_ > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        void* ptr = std::malloc(n_ * sizeof(T));
+        if (ptr == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    // Reports the whole malloc size class as capacity, so RawMemory can use the slack instead of wasting it
+    AllocationResult<T*> allocate_at_least(size_t n_)
+    {
+        T* ptr = allocate(n_);
+#if defined(__GLIBC__)
+        return { ptr, std::max(n_, malloc_usable_size(ptr) / sizeof(T)) };
+#else
+        return { ptr, n_ };
+#endif
+    }
+
+    void deallocate(T* ptr_, size_t) noexcept
+    {
+        std::free(ptr_);
+    }
+
+    T* reallocate(T* ptr_, size_t, size_t new_n_)
+    {
+        if (new_n_ > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        void* new_ptr = std::realloc(static_cast<void*>(ptr_), new_n_ * sizeof(T));
+        if (new_ptr == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_ptr);
+    }
+
+    friend bool operator==(const MallocAllocator&, const MallocAllocator&) noexcept
+    {
+        return true;
+    }
+};
+
+//--------------------------------------------------------------------AlignedAllocator-----------------------------------------------------
+// Hands out blocks aligned to Alignment bytes (e.g. 32 for AVX, 64 for a cache line) through the align_val_t forms of operator new
+
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+
+    static constexpr size_t BlockAlignment = std::max(Alignment, alignof(T));
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n_)
+    {
+        if (n_ > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n_ * sizeof(T), std::align_val_t(BlockAlignment)));
+    }
+
+    void deallocate(T* ptr_, size_t n_) noexcept
+    {
+        ::operator delete(static_cast<void*>(ptr_), n_ * sizeof(T), std::align_val_t(BlockAlignment));
+    }
+
+    friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) noexcept
+    {
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------HugePageAllocator-----------------------------------------------------
+// Blocks of at least ThresholdBytes are mapped directly, rounded up to whole 2 MiB pages and marked MADV_HUGEPAGE so that
+// transparent huge pages back them; smaller blocks come from AlignedAllocator<T, Alignment>
+
+template <typename T, size_t Alignment = 64, size_t ThresholdBytes = size_t(2) << 20>
+class HugePageAllocator
+{
+public:
+
+    static constexpr size_t HugePageSize = size_t(2) << 20;
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = HugePageAllocator<U, Alignment, ThresholdBytes>;
+    };
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Alignment, ThresholdBytes>&) noexcept {}
+
+    T* allocate(size_t n_)
+    {
+        return allocate_at_least(n_).ptr;
+    }
+
+    // Mapped blocks report the whole rounded-up mapping as capacity
+    AllocationResult<T*> allocate_at_least(size_t n_)
+    {
+        if (n_ > std::numeric_limits<size_t>::max() / sizeof(T) - HugePageSize)
+        {
+            throw std::bad_array_new_length();
+        }
+        if (!IsMapped(n_))
+        {
+            return { AlignedAllocator<T, Alignment>().allocate(n_), n_ };
+        }
+#if defined(__linux__)
+        const size_t bytes = MappedBytes(n_);
+        // Over-map by one huge page so the block can start on a huge page boundary, then trim both ends
+        const size_t reserved = bytes + HugePageSize;
+        void* raw = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        char* begin = static_cast<char*>(raw);
+        char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(begin) + HugePageSize - 1) & ~(HugePageSize - 1));
+        if (aligned != begin)
+        {
+            munmap(begin, aligned - begin);
+        }
+        if (size_t tail = (begin + reserved) - (aligned + bytes); tail != 0)
+        {
+            munmap(aligned + bytes, tail);
+        }
+#if defined(MADV_HUGEPAGE)
+        madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+        return { reinterpret_cast<T*>(aligned), bytes / sizeof(T) };
+#else
+        return { AlignedAllocator<T, Alignment>().allocate(n_), n_ };
+#endif
+    }
+
+    void deallocate(T* ptr_, size_t n_) noexcept
+    {
+#if defined(__linux__)
+        if (IsMapped(n_))
+        {
+            munmap(static_cast<void*>(ptr_), MappedBytes(n_));
+            return;
+        }
+#endif
+        AlignedAllocator<T, Alignment>().deallocate(ptr_, n_);
+    }
+
+    friend bool operator==(const HugePageAllocator&, const HugePageAllocator&) noexcept
+    {
+        return true;
+    }
+
+private:
+
+    static bool IsMapped(size_t n_) noexcept
+    {
+        return n_ * sizeof(T) >= ThresholdBytes;
+    }
+
+    static size_t MappedBytes(size_t n_) noexcept
+    {
+        return (n_ * sizeof(T) + HugePageSize - 1) & ~(HugePageSize - 1);
+    }
+};
+
+//-------------------------------------------------------------------PoolAllocator---------------------------------------------------------
+// Thread-local cache of freed buffers, bucketed by power-of-two byte size. Blocks of up to MaxPooledBytes are rounded up to
+// their bucket and come back to the freeing thread's list, so a Vector's regrowth, ShrinkToFit and destruction feed the next
+// allocations of a similar size instead of the global heap. Each thread keeps at most MaxCachedBytes; the rest is freed
+
+struct BufferPoolStats
+{
+    uint64_t hits = 0;      // allocations served from the cache
+    uint64_t misses = 0;    // allocations that went to operator new
+    uint64_t releases = 0;  // blocks put back into the cache
+    uint64_t drops = 0;     // blocks freed because the cache was full
+    size_t cached_bytes = 0;
+};
+
+class BufferPool
+{
+public:
+
+    static constexpr size_t MinPooledBytes = 64;
+    static constexpr size_t MaxPooledBytes = size_t(1) << 20;
+    static constexpr size_t MaxCachedBytes = size_t(8) << 20;
+    static constexpr size_t BucketCount = std::countr_zero(MaxPooledBytes) - std::countr_zero(MinPooledBytes) + 1;
+
+    // The calling thread's pool. The pool itself is trivially destructible and stays usable while the thread's other
+    // objects are torn down; the closer empties it at thread exit, and blocks freed after that bypass the cache
+    static BufferPool& Local() noexcept
+    {
+        thread_local BufferPool pool;
+        thread_local Closer closer{ pool };
+        return pool;
+    }
+
+    // Byte size actually handed out for a request of bytes_
+    static size_t BlockBytes(size_t bytes_) noexcept
+    {
+        return bytes_ > MaxPooledBytes ? bytes_ : std::bit_ceil(std::max(bytes_, MinPooledBytes));
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    void* Allocate(size_t bytes_)
+    {
+        if (bytes_ > MaxPooledBytes)
+        {
+            ++stats.misses;
+            return ::operator new(bytes_);
+        }
+        const size_t bucket = BucketOf(bytes_);
+        if (FreeBlock* block = buckets[bucket])
+        {
+            buckets[bucket] = block->next;
+            stats.cached_bytes -= BucketBytes(bucket);
+            ++stats.hits;
+            return block;
+        }
+        ++stats.misses;
+        return ::operator new(BucketBytes(bucket));
+    }
+
+    // bytes_ is the size passed to Allocate (or the rounded-up block size it reported)
+    void Deallocate(void* ptr_, size_t bytes_) noexcept
+    {
+        if (bytes_ > MaxPooledBytes)
+        {
+            ::operator delete(ptr_, bytes_);
+            return;
+        }
+        const size_t bucket = BucketOf(bytes_);
+        if (closed || stats.cached_bytes + BucketBytes(bucket) > MaxCachedBytes)
+        {
+            ++stats.drops;
+            ::operator delete(ptr_, BucketBytes(bucket));
+            return;
+        }
+        buckets[bucket] = ::new (ptr_) FreeBlock{ buckets[bucket] };
+        stats.cached_bytes += BucketBytes(bucket);
+        ++stats.releases;
+    }
+
+    // Frees every cached block
+    void Trim() noexcept
+    {
+        for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            while (FreeBlock* block = buckets[bucket])
+            {
+                buckets[bucket] = block->next;
+                ::operator delete(static_cast<void*>(block), BucketBytes(bucket));
+            }
+        }
+        stats.cached_bytes = 0;
+    }
+
+    const BufferPoolStats& Stats() const noexcept
+    {
+        return stats;
+    }
+
+    void ResetStats() noexcept
+    {
+        stats = BufferPoolStats{ 0, 0, 0, 0, stats.cached_bytes };
+    }
+
+private:
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Closer
+    {
+        ~Closer()
+        {
+            pool.Trim();
+            pool.closed = true;
+        }
+
+        BufferPool& pool;
+    };
+
+    BufferPool() noexcept = default;
+
+    static size_t BucketOf(size_t bytes_) noexcept
+    {
+        return std::countr_zero(BlockBytes(bytes_)) - std::countr_zero(MinPooledBytes);
+    }
+
+    static size_t BucketBytes(size_t bucket_) noexcept
+    {
+        return MinPooledBytes << bucket_;
+    }
+
+    FreeBlock* buckets[BucketCount] = {};
+    BufferPoolStats stats;
+    bool closed = false;
+};
+
+template <typename T>
+class PoolAllocator
+{
+public:
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "pooled blocks only have operator new's default alignment");
+
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n_)
+    {
+        if (n_ > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(BufferPool::Local().Allocate(n_ * sizeof(T)));
+    }
+
+    // The whole bucket is reported as capacity
+    AllocationResult<T*> allocate_at_least(size_t n_)
+    {
+        T* ptr = allocate(n_);
+        return { ptr, std::max(n_, BufferPool::BlockBytes(n_ * sizeof(T)) / sizeof(T)) };
+    }
+
+    void deallocate(T* ptr_, size_t n_) noexcept
+    {
+        BufferPool::Local().Deallocate(static_cast<void*>(ptr_), n_ * sizeof(T));
+    }
+
+    size_t footprint(size_t n_) const noexcept
+    {
+        return BufferPool::BlockBytes(n_ * sizeof(T));
+    }
+
+    friend bool operator==(const PoolAllocator&, const PoolAllocator&) noexcept
+    {
+        return true;
+    }
+};
+
+#if defined(__linux__)
+//-----------------------------------------------------------------VirtualMemoryAllocator--------------------------------------------------
+// Reserves ReserveBytes of address space per block (PROT_NONE, MAP_NORESERVE, so nothing is committed up front) and makes
+// only the pages in use accessible. Vector grows and shrinks such a block through resize_in_place, so Data() never moves
+// and growth never relocates; ShrinkToFit hands the pages past Size() back to the kernel with MADV_DONTNEED
+
+template <typename T, size_t ReserveBytes = size_t(64) << 30>
+class VirtualMemoryAllocator
+{
+public:
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = VirtualMemoryAllocator<U, ReserveBytes>;
+    };
+
+    VirtualMemoryAllocator() noexcept = default;
+
+    template <typename U>
+    VirtualMemoryAllocator(const VirtualMemoryAllocator<U, ReserveBytes>&) noexcept {}
+
+    T* allocate(size_t n_)
+    {
+        return allocate_at_least(n_).ptr;
+    }
+
+    // The committed pages are reported as capacity
+    AllocationResult<T*> allocate_at_least(size_t n_)
+    {
+        if (n_ > max_size())
+        {
+            throw std::bad_array_new_length();
+        }
+        void* raw = mmap(nullptr, ReservedBytes(), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        const size_t bytes = CommittedBytes(n_);
+        if (bytes != 0 && mprotect(raw, bytes, PROT_READ | PROT_WRITE) != 0)
+        {
+            munmap(raw, ReservedBytes());
+            throw std::bad_alloc();
+        }
+        return { static_cast<T*>(raw), bytes / sizeof(T) };
+    }
+
+    void deallocate(T* ptr_, size_t) noexcept
+    {
+        munmap(static_cast<void*>(ptr_), ReservedBytes());
+    }
+
+    // Commits or releases the pages between old_n_ and new_n_ elements; false when new_n_ does not fit the reservation
+    bool resize_in_place(T* ptr_, size_t old_n_, size_t new_n_) noexcept
+    {
+        if (new_n_ > max_size())
+        {
+            return false;
+        }
+        char* base = reinterpret_cast<char*>(ptr_);
+        const size_t old_bytes = CommittedBytes(old_n_);
+        const size_t new_bytes = CommittedBytes(new_n_);
+        if (new_bytes > old_bytes)
+        {
+            return mprotect(base + old_bytes, new_bytes - old_bytes, PROT_READ | PROT_WRITE) == 0;
+        }
+        if (new_bytes < old_bytes)
+        {
+            madvise(base + new_bytes, old_bytes - new_bytes, MADV_DONTNEED);
+            mprotect(base + new_bytes, old_bytes - new_bytes, PROT_NONE);
+        }
+        return true;
+    }
+
+    static size_t max_size() noexcept
+    {
+        return ReservedBytes() / sizeof(T);
+    }
+
+    // Only committed pages count; the rest of the reservation is address space, not memory
+    size_t footprint(size_t n_) const noexcept
+    {
+        return CommittedBytes(n_);
+    }
+
+    friend bool operator==(const VirtualMemoryAllocator&, const VirtualMemoryAllocator&) noexcept
+    {
+        return true;
+    }
+
+private:
+
+    static size_t PageSize() noexcept
+    {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page_size;
+    }
+
+    static size_t ReservedBytes() noexcept
+    {
+        return (ReserveBytes + PageSize() - 1) & ~(PageSize() - 1);
+    }
+
+    static size_t CommittedBytes(size_t n_) noexcept
+    {
+        return (n_ * sizeof(T) + PageSize() - 1) & ~(PageSize() - 1);
+    }
+};
+#endif
+
+#if defined(__linux__)
+//----------------------------------------------------------------------NumaAllocator-----------------------------------------------------
+// Blocks of at least ThresholdBytes are mapped directly and get a NUMA memory policy (mbind) before any page is touched:
+// Interleave spreads the pages round-robin over the nodes the process may use, for data that every socket reads; Bind
+// and Preferred put them on node(); Local leaves it to first touch, so the thread that first writes a page gets it on its
+// own node (see Vector's parallel constructor and Resize(size_, executor_)). Smaller blocks come from AlignedAllocator,
+// where a policy would also move neighbouring allocations. The policy is a hint: without NUMA support mbind just fails
+
+enum class NumaPolicy
+{
+    Local,
+    Interleave,
+    Bind,
+    Preferred
+};
+
+template <typename T, size_t ThresholdBytes = size_t(1) << 20>
+class NumaAllocator
+{
+public:
+
+    using value_type = T;
+    // The pages keep their placement when the buffer changes hands, so moves and swaps take the allocator along
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = NumaAllocator<U, ThresholdBytes>;
+    };
+
+    explicit NumaAllocator(NumaPolicy policy_ = NumaPolicy::Interleave, int node_ = 0) noexcept : policy(policy_), node(node_) {}
+
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U, ThresholdBytes>& other_) noexcept : policy(other_.Policy()), node(other_.Node()) {}
+
+    NumaPolicy Policy() const noexcept
+    {
+        return policy;
+    }
+
+    int Node() const noexcept
+    {
+        return node;
+    }
+
+    T* allocate(size_t n_)
+    {
+        return allocate_at_least(n_).ptr;
+    }
+
+    // Mapped blocks report the whole page-rounded mapping as capacity
+    AllocationResult<T*> allocate_at_least(size_t n_)
+    {
+        if (n_ > (std::numeric_limits<size_t>::max() - PageSize()) / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        if (!IsMapped(n_))
+        {
+            return { AlignedAllocator<T>().allocate(n_), n_ };
+        }
+        const size_t bytes = MappedBytes(n_);
+        void* raw = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        ApplyPolicy(raw, bytes);
+        return { static_cast<T*>(raw), bytes / sizeof(T) };
+    }
+
+    void deallocate(T* ptr_, size_t n_) noexcept
+    {
+        if (IsMapped(n_))
+        {
+            munmap(static_cast<void*>(ptr_), MappedBytes(n_));
+            return;
+        }
+        AlignedAllocator<T>().deallocate(ptr_, n_);
+    }
+
+    friend bool operator==(const NumaAllocator& lhs_, const NumaAllocator& rhs_) noexcept
+    {
+        return lhs_.policy == rhs_.policy && lhs_.node == rhs_.node;
+    }
+
+private:
+
+    // Node masks cover the kernel's default maximum of 1024 nodes
+    static constexpr size_t MaskBits = 1024;
+    static constexpr size_t MaskWords = MaskBits / (8 * sizeof(unsigned long));
+
+    struct NodeMask
+    {
+        unsigned long words[MaskWords] = {};
+    };
+
+    NumaPolicy policy;
+    int node;
+
+    static size_t PageSize() noexcept
+    {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page_size;
+    }
+
+    static bool IsMapped(size_t n_) noexcept
+    {
+        return n_ * sizeof(T) >= ThresholdBytes;
+    }
+
+    static size_t MappedBytes(size_t n_) noexcept
+    {
+        return (n_ * sizeof(T) + PageSize() - 1) & ~(PageSize() - 1);
+    }
+
+#if defined(SYS_mbind) && defined(MPOL_F_MEMS_ALLOWED)
+    // The nodes this process may allocate on (its cpuset), read once
+    static const NodeMask& AllowedNodes() noexcept
+    {
+        static const NodeMask allowed = []() noexcept
+        {
+            NodeMask mask;
+            int mode = 0;
+            if (syscall(SYS_get_mempolicy, &mode, mask.words, MaskBits, nullptr, MPOL_F_MEMS_ALLOWED) != 0)
+            {
+                mask = NodeMask();
+                mask.words[0] = 1;
+            }
+            return mask;
+        }();
+        return allowed;
+    }
+
+    void ApplyPolicy(void* ptr_, size_t bytes_) const noexcept
+    {
+        if (policy == NumaPolicy::Local || node < 0 || static_cast<size_t>(node) >= MaskBits)
+        {
+            return;
+        }
+        NodeMask mask = AllowedNodes();
+        int mode = MPOL_INTERLEAVE;
+        if (policy != NumaPolicy::Interleave)
+        {
+            mask = NodeMask();
+            mask.words[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+            mode = policy == NumaPolicy::Bind ? MPOL_BIND : MPOL_PREFERRED;
+        }
+        // The kernel reads maxnode - 1 bits of the mask
+        syscall(SYS_mbind, ptr_, bytes_, mode, mask.words, MaskBits + 1, 0);
+    }
+#else
+    void ApplyPolicy(void*, size_t) const noexcept {}
+#endif
+};
+#endif
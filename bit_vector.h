@@ -0,0 +1,447 @@
+#pragma once
+#include "custom_vector.h"
+
+namespace bit_detail
+{
+    constexpr size_t WordBits = 64;
+
+    constexpr size_t WordsFor(size_t bits_) noexcept
+    {
+        return (bits_ + WordBits - 1) / WordBits;
+    }
+
+    // Mask of the bits_ % 64 low bits that are in use in the last word (all of them when the last word is full)
+    constexpr uint64_t TailMask(size_t bits_) noexcept
+    {
+        return bits_ % WordBits == 0 ? ~uint64_t(0) : (uint64_t(1) << (bits_ % WordBits)) - 1;
+    }
+
+    // Gathers the bits of value_ selected by mask_ into the low bits, in order (BMI2 pext)
+    inline uint64_t ExtractBits(uint64_t value_, uint64_t mask_) noexcept
+    {
+#if defined(__BMI2__)
+        return _pext_u64(value_, mask_);
+#else
+        uint64_t result = 0;
+        for (uint64_t bit = 1; mask_ != 0; bit <<= 1)
+        {
+            if (value_ & mask_ & (~mask_ + 1))
+            {
+                result |= bit;
+            }
+            mask_ &= mask_ - 1;
+        }
+        return result;
+#endif
+    }
+
+    // Number of set bits in n_ words. Vectorized with AVX-512 VPOPCNTDQ, or with the AVX2 nibble-table method
+    inline size_t PopCount(const uint64_t* words_, size_t n_) noexcept
+    {
+        size_t i = 0;
+        size_t total = 0;
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+        __m512i sums = _mm512_setzero_si512();
+        for (; i + 8 <= n_; i += 8)
+        {
+            sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(_mm512_loadu_si512(words_ + i)));
+        }
+        total += static_cast<size_t>(_mm512_reduce_add_epi64(sums));
+#elif defined(__AVX2__)
+        const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+        __m256i sums = _mm256_setzero_si256();
+        for (; i + 4 <= n_; i += 4)
+        {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words_ + i));
+            const __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(block, low_nibbles));
+            const __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibbles));
+            // Per-byte counts are at most 8, so summing them with sad against zero cannot overflow
+            sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+        total += static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+        for (; i < n_; ++i)
+        {
+            total += static_cast<size_t>(std::popcount(words_[i]));
+        }
+        return total;
+    }
+
+    // Index of the first non-zero word at or after first_, or n_ when there is none; AVX2 tests four words at a time
+    inline size_t FindNonZeroWord(const uint64_t* words_, size_t first_, size_t n_) noexcept
+    {
+        size_t i = first_;
+#if defined(__AVX2__)
+        for (; i + 4 <= n_; i += 4)
+        {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words_ + i));
+            if (!_mm256_testz_si256(block, block))
+            {
+                break;
+            }
+        }
+#endif
+        for (; i < n_; ++i)
+        {
+            if (words_[i] != 0)
+            {
+                return i;
+            }
+        }
+        return n_;
+    }
+}
+
+// Vector of bits packed 64 to a word. The words live in a Vector<uint64_t, Alloc, Growth>, so growth and Reserve follow
+// Vector's rules; bits past Size() in the last word are always zero
+template <typename Alloc = std::allocator<uint64_t>, typename Growth = DoublingGrowth>
+class BasicBitVector
+{
+public:
+
+    using WordVector = Vector<uint64_t, Alloc, Growth>;
+
+    // Proxy returned by the non-const operator[]
+    class Reference
+    {
+    public:
+
+        Reference(uint64_t& word_, uint64_t bit_) noexcept : word(&word_), bit(bit_) {}
+
+        Reference& operator=(bool value_) noexcept
+        {
+            *word = value_ ? (*word | bit) : (*word & ~bit);
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other_) noexcept
+        {
+            return *this = bool(other_);
+        }
+
+        operator bool() const noexcept
+        {
+            return (*word & bit) != 0;
+        }
+
+        void Flip() noexcept
+        {
+            *word ^= bit;
+        }
+
+    private:
+
+        uint64_t* word;
+        uint64_t bit;
+    };
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    BasicBitVector() = default;
+
+    explicit BasicBitVector(size_t size_, bool value_ = false)
+    {
+        Resize(size_, value_);
+    }
+
+    BasicBitVector(std::initializer_list<bool> init_list_)
+    {
+        Reserve(init_list_.size());
+        for (bool value : init_list_)
+        {
+            PushBack(value);
+        }
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    bool operator[](size_t index_) const noexcept
+    {
+        assert(index_ < size);
+        return (words[index_ / bit_detail::WordBits] >> (index_ % bit_detail::WordBits)) & 1;
+    }
+
+    Reference operator[](size_t index_) noexcept
+    {
+        assert(index_ < size);
+        return Reference(words[index_ / bit_detail::WordBits], uint64_t(1) << (index_ % bit_detail::WordBits));
+    }
+
+    // Word-wise logic on vectors of the same size
+    BasicBitVector& operator&=(const BasicBitVector& rhs_) noexcept
+    {
+        assert(size == rhs_.size);
+        for (size_t i = 0; i < words.Size(); ++i)
+        {
+            words[i] &= rhs_.words[i];
+        }
+        return *this;
+    }
+
+    BasicBitVector& operator|=(const BasicBitVector& rhs_) noexcept
+    {
+        assert(size == rhs_.size);
+        for (size_t i = 0; i < words.Size(); ++i)
+        {
+            words[i] |= rhs_.words[i];
+        }
+        return *this;
+    }
+
+    BasicBitVector& operator^=(const BasicBitVector& rhs_) noexcept
+    {
+        assert(size == rhs_.size);
+        for (size_t i = 0; i < words.Size(); ++i)
+        {
+            words[i] ^= rhs_.words[i];
+        }
+        return *this;
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return words.Capacity() * bit_detail::WordBits;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    // The packed words; bit i is bit i % 64 of word i / 64
+    const WordVector& Words() const noexcept
+    {
+        return words;
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        words.Reserve(bit_detail::WordsFor(new_capacity_));
+    }
+
+    void ShrinkToFit()
+    {
+        words.ShrinkToFit();
+    }
+
+    size_t MemoryFootprint() const noexcept
+    {
+        return words.MemoryFootprint();
+    }
+
+    void Clear() noexcept
+    {
+        words.Clear();
+        size = 0;
+    }
+
+    bool Test(size_t index_) const noexcept
+    {
+        return (*this)[index_];
+    }
+
+    void Set(size_t index_, bool value_ = true) noexcept
+    {
+        (*this)[index_] = value_;
+    }
+
+    void Reset(size_t index_) noexcept
+    {
+        (*this)[index_] = false;
+    }
+
+    void Flip(size_t index_) noexcept
+    {
+        (*this)[index_].Flip();
+    }
+
+    void SetAll(bool value_ = true) noexcept
+    {
+        std::fill(words.begin(), words.end(), value_ ? ~uint64_t(0) : 0);
+        ClearTail();
+    }
+
+    void FlipAll() noexcept
+    {
+        for (uint64_t& word : words)
+        {
+            word = ~word;
+        }
+        ClearTail();
+    }
+
+    void PushBack(bool value_)
+    {
+        if (size % bit_detail::WordBits == 0)
+        {
+            words.PushBack(0);
+        }
+        if (value_)
+        {
+            words.Back() |= uint64_t(1) << (size % bit_detail::WordBits);
+        }
+        ++size;
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size);
+        --size;
+        if (size % bit_detail::WordBits == 0)
+        {
+            words.PopBack();
+        }
+        else
+        {
+            words.Back() &= bit_detail::TailMask(size);
+        }
+    }
+
+    bool Back() const noexcept
+    {
+        return (*this)[size - 1];
+    }
+
+    void Resize(size_t new_size_, bool value_ = false)
+    {
+        if (new_size_ <= size)
+        {
+            words.Resize(bit_detail::WordsFor(new_size_));
+            size = new_size_;
+            ClearTail();
+            return;
+        }
+        if (value_ && size % bit_detail::WordBits != 0)
+        {
+            words.Back() |= ~bit_detail::TailMask(size);
+        }
+        const size_t old_words = words.Size();
+        words.Resize(bit_detail::WordsFor(new_size_));
+        std::fill(words.begin() + old_words, words.end(), value_ ? ~uint64_t(0) : 0);
+        size = new_size_;
+        ClearTail();
+    }
+
+    // Number of set bits
+    size_t Count() const noexcept
+    {
+        return bit_detail::PopCount(words.Data(), words.Size());
+    }
+
+    bool Any() const noexcept
+    {
+        return bit_detail::FindNonZeroWord(words.Data(), 0, words.Size()) != words.Size();
+    }
+
+    bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    // Index of the first set bit at or after from_, or Size() when there is none
+    size_t FindNext(size_t from_) const noexcept
+    {
+        if (from_ >= size)
+        {
+            return size;
+        }
+        size_t word = from_ / bit_detail::WordBits;
+        const uint64_t first = words[word] & (~uint64_t(0) << (from_ % bit_detail::WordBits));
+        if (first != 0)
+        {
+            return word * bit_detail::WordBits + std::countr_zero(first);
+        }
+        word = bit_detail::FindNonZeroWord(words.Data(), word + 1, words.Size());
+        return word == words.Size() ? size : word * bit_detail::WordBits + std::countr_zero(words[word]);
+    }
+
+    size_t FindFirst() const noexcept
+    {
+        return FindNext(0);
+    }
+
+    // Removes every bit whose mask_ bit is set, a word at a time: the survivors of each word are gathered with pext
+    // and appended behind the survivors so far. Returns the number of removed bits
+    size_t EraseMask(const BasicBitVector& mask_) noexcept
+    {
+        assert(mask_.size >= size);
+        size_t write = 0;
+        for (size_t i = 0; i < words.Size(); ++i)
+        {
+            const uint64_t valid = i + 1 == words.Size() ? bit_detail::TailMask(size) : ~uint64_t(0);
+            const uint64_t keep = ~mask_.words[i] & valid;
+            const uint64_t bits = bit_detail::ExtractBits(words[i], keep);
+            const size_t count = static_cast<size_t>(std::popcount(keep));
+            // write <= 64 * i, so the words written are at most word i, which has already been read
+            AppendBitsAt(write, bits, count);
+            write += count;
+        }
+        const size_t erased = size - write;
+        words.Resize(bit_detail::WordsFor(write));
+        size = write;
+        ClearTail();
+        return erased;
+    }
+
+    void Swap(BasicBitVector& other_) noexcept
+    {
+        words.Swap(other_.words);
+        std::swap(size, other_.size);
+    }
+
+private:
+
+    WordVector words;
+    size_t size = 0;
+
+    void ClearTail() noexcept
+    {
+        if (!words.IsEmpty())
+        {
+            words.Back() &= bit_detail::TailMask(size);
+        }
+    }
+
+    // Writes the low count_ bits of bits_ at bit position position_, overwriting whatever was there
+    void AppendBitsAt(size_t position_, uint64_t bits_, size_t count_) noexcept
+    {
+        if (count_ == 0)
+        {
+            return;
+        }
+        const size_t word = position_ / bit_detail::WordBits;
+        const size_t offset = position_ % bit_detail::WordBits;
+        const uint64_t low_mask = offset == 0 ? 0 : (uint64_t(1) << offset) - 1;
+        words[word] = (words[word] & low_mask) | (bits_ << offset);
+        if (offset != 0 && offset + count_ > bit_detail::WordBits)
+        {
+            words[word + 1] = bits_ >> (bit_detail::WordBits - offset);
+        }
+    }
+};
+
+using BitVector = BasicBitVector<>;
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename Alloc, typename Growth>
+inline bool operator==(const BasicBitVector<Alloc, Growth>& lhs_, const BasicBitVector<Alloc, Growth>& rhs_)
+{
+    return lhs_.Size() == rhs_.Size() && lhs_.Words() == rhs_.Words();
+}
+template <typename Alloc, typename Growth>
+inline bool operator!=(const BasicBitVector<Alloc, Growth>& lhs_, const BasicBitVector<Alloc, Growth>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
@@ -0,0 +1,671 @@
+#pragma once
+#include "custom_vector.h"
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace concurrent_detail
+{
+    // About 4 KiB in the first segment, rounded down to a power of two; every further segment doubles the capacity
+    template <typename T>
+    constexpr size_t DefaultFirstSegmentSize() noexcept
+    {
+        return std::bit_floor(std::max<size_t>(16, (size_t(4) << 10) / sizeof(T)));
+    }
+}
+
+// Append-only vector for many producer threads. PushBack/EmplaceBack/GrowBy claim their slots with one fetch_add on a
+// shared counter and construct into segments that never move (segment k holds FirstSegmentSize << k elements), so no
+// lock is taken and nothing is ever relocated. Every finished slot is marked in a per-segment ready bitmap, and whoever
+// marks the slot that completes the prefix advances Size() past it, so no producer waits for another. Size() only counts
+// the prefix whose elements are completely constructed, and any index below a Size() a reader has seen is safe to
+// access from that reader. Appends, Reserve, Size, operator[], At and iteration may run concurrently; everything else (Clear, Swap,
+// assignment, Freeze, destruction) needs exclusive access.
+//
+// A claimed slot cannot be given back, so elements are constructed without throwing: arguments T is not nothrow
+// constructible from are turned into a temporary first, which is then moved in
+template <typename T, size_t FirstSegmentSize = concurrent_detail::DefaultFirstSegmentSize<T>(), typename Alloc = std::allocator<T>>
+class ConcurrentVector
+{
+public:
+
+    static_assert(std::has_single_bit(FirstSegmentSize), "first segment size must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "elements are moved into claimed slots, which must not throw");
+
+    static constexpr size_t FirstSegmentShift = std::countr_zero(FirstSegmentSize);
+    static constexpr size_t SegmentCount = std::numeric_limits<size_t>::digits - FirstSegmentShift;
+
+    using AllocatorType = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using ValueType = T;
+
+    template <bool IsConst>
+    class BasicIterator
+    {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(const ConcurrentVector* owner_, size_t index_) noexcept : owner(owner_), index(index_) {}
+
+        // Iterator -> ConstIterator
+        template <bool OtherConst> requires (IsConst && !OtherConst)
+        BasicIterator(const BasicIterator<OtherConst>& other_) noexcept : owner(other_.owner), index(other_.index) {}
+
+        reference operator*() const noexcept
+        {
+            return *owner->Slot(index);
+        }
+        pointer operator->() const noexcept
+        {
+            return owner->Slot(index);
+        }
+        reference operator[](difference_type offset_) const noexcept
+        {
+            return *(*this + offset_);
+        }
+
+        BasicIterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+        BasicIterator operator++(int) noexcept
+        {
+            BasicIterator copy = *this;
+            ++index;
+            return copy;
+        }
+        BasicIterator& operator--() noexcept
+        {
+            --index;
+            return *this;
+        }
+        BasicIterator operator--(int) noexcept
+        {
+            BasicIterator copy = *this;
+            --index;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type offset_) noexcept
+        {
+            index += offset_;
+            return *this;
+        }
+        BasicIterator& operator-=(difference_type offset_) noexcept
+        {
+            index -= offset_;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it_, difference_type offset_) noexcept
+        {
+            return it_ += offset_;
+        }
+        friend BasicIterator operator+(difference_type offset_, BasicIterator it_) noexcept
+        {
+            return it_ += offset_;
+        }
+        friend BasicIterator operator-(BasicIterator it_, difference_type offset_) noexcept
+        {
+            return it_ -= offset_;
+        }
+        friend difference_type operator-(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return static_cast<difference_type>(lhs_.index) - static_cast<difference_type>(rhs_.index);
+        }
+
+        friend bool operator==(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index == rhs_.index;
+        }
+        friend auto operator<=>(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index <=> rhs_.index;
+        }
+
+    private:
+
+        template <bool>
+        friend class BasicIterator;
+
+        const ConcurrentVector* owner = nullptr;
+        size_t index = 0;
+    };
+
+    // Iterators cover the elements published when begin()/end() were called
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc_) noexcept : allocator(alloc_) {}
+
+    ConcurrentVector(const ConcurrentVector& other_) : ConcurrentVector(AllocTraits::select_on_container_copy_construction(other_.allocator))
+    {
+        Reserve(other_.Size());
+        for (const T& item : other_)
+        {
+            EmplaceBack(item);
+        }
+    }
+
+    ConcurrentVector(ConcurrentVector&& other_) noexcept : allocator(other_.allocator)
+    {
+        Steal(other_);
+    }
+
+    ConcurrentVector(std::initializer_list<T> init_list_, const Alloc& alloc_ = Alloc()) : ConcurrentVector(alloc_)
+    {
+        Reserve(init_list_.size());
+        for (const T& item : init_list_)
+        {
+            EmplaceBack(item);
+        }
+    }
+
+    ~ConcurrentVector()
+    {
+        Clear();
+        for (size_t k = 0; k < SegmentCount; ++k)
+        {
+            if (T* segment = segments[k].load(std::memory_order_relaxed))
+            {
+                AllocTraits::deallocate(allocator, segment, SegmentSize(k));
+            }
+            if (ReadyWord* words = ready[k].load(std::memory_order_relaxed))
+            {
+                FreeReady(words, k);
+            }
+        }
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    ConcurrentVector& operator=(const ConcurrentVector& rhs_)
+    {
+        if (this != &rhs_)
+        {
+            ConcurrentVector copy(rhs_);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    ConcurrentVector& operator=(ConcurrentVector&& rhs_) noexcept(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+    {
+        if (this != &rhs_)
+        {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+            {
+                AdoptSegments(rhs_);
+            }
+            else if (allocator == rhs_.allocator)
+            {
+                AdoptSegments(rhs_);
+            }
+            else
+            {
+                // Unequal allocators that do not propagate: rhs_'s segments cannot change hands, so move element-wise
+                Clear();
+                const size_t count = rhs_.Size();
+                Reserve(count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    EmplaceBack(std::move(rhs_[i]));
+                }
+            }
+        }
+        return *this;
+    }
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        assert(index_ < Size());
+        return *Slot(index_);
+    }
+
+    T& operator[](size_t index_) noexcept
+    {
+        assert(index_ < Size());
+        return *Slot(index_);
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Iterator(this, 0);
+    }
+    Iterator end() noexcept
+    {
+        return Iterator(this, Size());
+    }
+
+    ConstIterator cbegin() const noexcept
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator cend() const noexcept
+    {
+        return ConstIterator(this, Size());
+    }
+
+    ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    // Elements that are completely constructed; loading it makes all of them visible to the caller
+    size_t Size() const noexcept
+    {
+        return published.load(std::memory_order_acquire);
+    }
+
+    // Allocated slots, claimed or not
+    size_t Capacity() const noexcept
+    {
+        size_t capacity = 0;
+        for (size_t k = 0; k < SegmentCount && segments[k].load(std::memory_order_acquire) != nullptr; ++k)
+        {
+            capacity += SegmentSize(k);
+        }
+        return capacity;
+    }
+
+    Alloc Allocator() const noexcept
+    {
+        return allocator;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    T& At(size_t index_)
+    {
+        if (index_ >= Size())
+        {
+            throw std::out_of_range("ConcurrentVector::At");
+        }
+        return *Slot(index_);
+    }
+    const T& At(size_t index_) const
+    {
+        return const_cast<ConcurrentVector&>(*this).At(index_);
+    }
+
+    // Allocates the segments for the first new_capacity_ slots; safe to call while other threads append
+    void Reserve(size_t new_capacity_)
+    {
+        if (new_capacity_ == 0)
+        {
+            return;
+        }
+        for (size_t k = 0, last = SegmentOf(new_capacity_ - 1); k <= last; ++k)
+        {
+            if (segments[k].load(std::memory_order_acquire) == nullptr)
+            {
+                InstallSegment(k);
+            }
+        }
+    }
+
+    // Destroys the elements but keeps every segment for reuse
+    void Clear() noexcept
+    {
+        const size_t count = published.load(std::memory_order_relaxed);
+        ForEachRun(0, count, [this](T* first_, size_t, size_t n_)
+        {
+            vector_detail::DestroyN(allocator, first_, n_);
+        });
+        Forget();
+    }
+
+    // Allocators that do not propagate on swap must compare equal, as for any allocator-aware container
+    void Swap(ConcurrentVector& other_) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(allocator, other_.allocator);
+        }
+        else
+        {
+            assert(allocator == other_.allocator);
+        }
+        for (size_t k = 0; k < SegmentCount; ++k)
+        {
+            segments[k].store(other_.segments[k].exchange(segments[k].load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+            ready[k].store(other_.ready[k].exchange(ready[k].load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        claimed.store(other_.claimed.exchange(claimed.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+        published.store(other_.published.exchange(published.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Turns the elements into one contiguous Vector. They are moved (one memcpy per segment for trivially copyable T)
+    // into a single exactly sized block rather than copied, and the segments are kept for reuse
+    Vector<T, Alloc> Freeze() &&
+    {
+        Vector<T, Alloc> result(allocator);
+        const size_t count = published.load(std::memory_order_relaxed);
+        result.Reserve(count);
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            T* dest = result.SpareCapacity().data();
+            ForEachRun(0, count, [dest](T* first_, size_t index_, size_t n_)
+            {
+                std::memcpy(static_cast<void*>(dest + index_), static_cast<const void*>(first_), n_ * sizeof(T));
+            });
+            result.CommitSize(count);
+        }
+        else
+        {
+            ForEachRun(0, count, [&result](T* first_, size_t, size_t n_)
+            {
+                result.AppendRange(std::make_move_iterator(first_), std::make_move_iterator(first_ + n_));
+            });
+        }
+        Clear();
+        return result;
+    }
+
+    template <typename Type>
+    void PushBack(Type&& value_)
+    {
+        EmplaceBack(std::forward<Type>(value_));
+    }
+
+    // Appends count_ value-initialized elements and returns the index of the first one
+    size_t GrowBy(size_t count_) requires std::is_nothrow_default_constructible_v<T>
+    {
+        return Append(count_, [this](T* first_, size_t, size_t n_) noexcept
+        {
+            vector_detail::UninitializedValueConstructN(allocator, first_, n_);
+        });
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args_);
+
+private:
+
+    // One bit per slot of a segment, set once the element is constructed
+    using ReadyWord = std::atomic<uint64_t>;
+    using ReadyAlloc = typename AllocTraits::template rebind_alloc<ReadyWord>;
+    using ReadyTraits = std::allocator_traits<ReadyAlloc>;
+
+    static constexpr size_t ReadyBits = 64;
+
+    [[no_unique_address]] Alloc allocator;
+    std::atomic<T*> segments[SegmentCount] = {};
+    std::atomic<ReadyWord*> ready[SegmentCount] = {};
+    std::atomic<size_t> claimed{ 0 };   // slots handed out to appenders
+    std::atomic<size_t> published{ 0 }; // prefix of claimed slots whose elements are constructed
+
+    static constexpr size_t SegmentSize(size_t k_) noexcept
+    {
+        return FirstSegmentSize << k_;
+    }
+
+    // Segment k_ starts at FirstSegmentSize * (2^k_ - 1), so the segment is the bit width of index_ + FirstSegmentSize
+    static constexpr size_t SegmentOf(size_t index_) noexcept
+    {
+        return std::bit_width(index_ + FirstSegmentSize) - 1 - FirstSegmentShift;
+    }
+
+    static constexpr size_t SegmentStart(size_t k_) noexcept
+    {
+        return SegmentSize(k_) - FirstSegmentSize;
+    }
+
+    static constexpr size_t ReadyWords(size_t k_) noexcept
+    {
+        return (SegmentSize(k_) + ReadyBits - 1) / ReadyBits;
+    }
+
+    void FreeReady(ReadyWord* words_, size_t k_) const noexcept
+    {
+        ReadyAlloc alloc(allocator);
+        vector_detail::DestroyN(alloc, words_, ReadyWords(k_));
+        ReadyTraits::deallocate(alloc, words_, ReadyWords(k_));
+    }
+
+    T* Slot(size_t index_) const noexcept
+    {
+        const size_t k = SegmentOf(index_);
+        return segments[k].load(std::memory_order_relaxed) + (index_ - SegmentStart(k));
+    }
+
+    // Losing the race to another installer just gives the block back. The ready bitmap goes in first, so a thread that
+    // sees the segment (acquire) sees its bitmap as well
+    T* InstallSegment(size_t k_)
+    {
+        if (ready[k_].load(std::memory_order_acquire) == nullptr)
+        {
+            ReadyAlloc ready_alloc(allocator);
+            ReadyWord* words = ReadyTraits::allocate(ready_alloc, ReadyWords(k_));
+            vector_detail::UninitializedValueConstructN(ready_alloc, words, ReadyWords(k_));
+            ReadyWord* expected = nullptr;
+            if (!ready[k_].compare_exchange_strong(expected, words, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                FreeReady(words, k_);
+            }
+        }
+        Alloc alloc(allocator);
+        T* segment = AllocTraits::allocate(alloc, SegmentSize(k_));
+        T* expected = nullptr;
+        if (!segments[k_].compare_exchange_strong(expected, segment, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            AllocTraits::deallocate(alloc, segment, SegmentSize(k_));
+            return expected;
+        }
+        return segment;
+    }
+
+    // Calls fn_(first_slot, index, n) for each part of [first_, first_ + count_) that lies in one segment, allocating
+    // segments that are still missing
+    template <typename Function>
+    void ForEachRun(size_t first_, size_t count_, Function&& fn_)
+    {
+        while (count_ > 0)
+        {
+            const size_t k = SegmentOf(first_);
+            T* segment = segments[k].load(std::memory_order_acquire);
+            if (segment == nullptr)
+            {
+                segment = InstallSegment(k);
+            }
+            const size_t offset = first_ - SegmentStart(k);
+            const size_t n = std::min(count_, SegmentSize(k) - offset);
+            fn_(segment + offset, first_, n);
+            first_ += n;
+            count_ -= n;
+        }
+    }
+
+    // Claims count_ slots, fills them with construct_ (which must not throw), marks them ready and advances Size() as far
+    // as the ready prefix now reaches; slots behind an unfinished claim are published by whoever finishes that claim.
+    // The segments are reserved before claiming, so an allocation failure normally throws with nothing claimed; only a
+    // segment first needed because of a racing claim is allocated afterwards, and failing there terminates
+    template <typename Construct>
+    size_t Append(size_t count_, Construct&& construct_)
+    {
+        if (count_ == 0)
+        {
+            return Size();
+        }
+        Reserve(claimed.load(std::memory_order_relaxed) + count_);
+        const size_t first = claimed.fetch_add(count_, std::memory_order_relaxed);
+        [&]() noexcept
+        {
+            ForEachRun(first, count_, [&](T* slot_, size_t index_, size_t n_) noexcept
+            {
+                construct_(slot_, index_, n_);
+                MarkReady(index_, n_);
+            });
+        }();
+        AdvancePublished();
+        return first;
+    }
+
+    // Sets the ready bits of [first_, first_ + count_), which lies in one segment. Sequentially consistent, like the
+    // loads in AdvancePublished: of two producers finishing neighbouring claims, at least one sees the other's bits
+    void MarkReady(size_t first_, size_t count_) noexcept
+    {
+        const size_t k = SegmentOf(first_);
+        ReadyWord* words = ready[k].load(std::memory_order_acquire);
+        for (size_t offset = first_ - SegmentStart(k), last = offset + count_; offset < last; )
+        {
+            const size_t bit = offset % ReadyBits;
+            const size_t n = std::min(ReadyBits - bit, last - offset);
+            const uint64_t mask = (n == ReadyBits ? ~uint64_t(0) : ((uint64_t(1) << n) - 1)) << bit;
+            words[offset / ReadyBits].fetch_or(mask, std::memory_order_seq_cst);
+            offset += n;
+        }
+    }
+
+    // First slot at or after index_ that is not ready
+    size_t ReadyPrefixEnd(size_t index_) const noexcept
+    {
+        for (;;)
+        {
+            const size_t k = SegmentOf(index_);
+            const ReadyWord* words = ready[k].load(std::memory_order_acquire);
+            if (words == nullptr)
+            {
+                return index_;
+            }
+            const size_t offset = index_ - SegmentStart(k);
+            const size_t bit = offset % ReadyBits;
+            // Bits of the word past the end of the segment are never set
+            const size_t available = std::min(ReadyBits - bit, SegmentSize(k) - offset);
+            const size_t run = std::min<size_t>(std::countr_one(words[offset / ReadyBits].load(std::memory_order_seq_cst) >> bit), available);
+            index_ += run;
+            if (run < available)
+            {
+                return index_;
+            }
+        }
+    }
+
+    // Moves published forward over the ready slots; concurrent callers either help or find nothing left to do
+    void AdvancePublished() noexcept
+    {
+        size_t current = published.load(std::memory_order_seq_cst);
+        for (;;)
+        {
+            const size_t end = ReadyPrefixEnd(current);
+            if (end == current)
+            {
+                return;
+            }
+            // A failed exchange reloads current, possibly already past end, and the scan resumes from there
+            if (published.compare_exchange_weak(current, end, std::memory_order_seq_cst))
+            {
+                current = end;
+            }
+        }
+    }
+
+    // Drops every element without destroying it and clears the ready bits of the claimed slots
+    void Forget() noexcept
+    {
+        const size_t count = claimed.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < SegmentCount && SegmentStart(k) < count; ++k)
+        {
+            if (ReadyWord* words = ready[k].load(std::memory_order_relaxed))
+            {
+                for (size_t i = 0; i < ReadyWords(k); ++i)
+                {
+                    words[i].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+        claimed.store(0, std::memory_order_relaxed);
+        published.store(0, std::memory_order_relaxed);
+    }
+
+    // Frees this vector's elements and segments, then takes over other_'s (and its allocator, when that propagates)
+    void AdoptSegments(ConcurrentVector& other_) noexcept
+    {
+        ConcurrentVector old(std::move(*this));
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            allocator = std::move(other_.allocator);
+        }
+        Steal(other_);
+    }
+
+    void Steal(ConcurrentVector& other_) noexcept
+    {
+        for (size_t k = 0; k < SegmentCount; ++k)
+        {
+            segments[k].store(other_.segments[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+            ready[k].store(other_.ready[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        claimed.store(other_.claimed.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        published.store(other_.published.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename T, size_t FirstSegmentSize, typename Alloc>
+template <typename... Args>
+T& ConcurrentVector<T, FirstSegmentSize, Alloc>::EmplaceBack(Args&&... args_)
+{
+    T* slot = nullptr;
+    if constexpr (std::is_nothrow_constructible_v<T, Args&&...>)
+    {
+        Append(1, [&](T* first_, size_t, size_t) noexcept
+        {
+            vector_detail::Construct(allocator, first_, std::forward<Args>(args_)...);
+            slot = first_;
+        });
+    }
+    else
+    {
+        T value(std::forward<Args>(args_)...);
+        Append(1, [&](T* first_, size_t, size_t) noexcept
+        {
+            vector_detail::Construct(allocator, first_, std::move(value));
+            slot = first_;
+        });
+    }
+    return *slot;
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename T, size_t FirstSegmentSize, typename Alloc>
+inline bool operator==(const ConcurrentVector<T, FirstSegmentSize, Alloc>& lhs_, const ConcurrentVector<T, FirstSegmentSize, Alloc>& rhs_)
+{
+    return std::equal(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+}
+template <typename T, size_t FirstSegmentSize, typename Alloc>
+inline bool operator!=(const ConcurrentVector<T, FirstSegmentSize, Alloc>& lhs_, const ConcurrentVector<T, FirstSegmentSize, Alloc>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
@@ -0,0 +1,451 @@
+#pragma once
+#include "custom_vector.h"
+#include <atomic>
+#include <compare>
+#include <memory>
+
+template <typename T, typename Alloc = std::allocator<T>>
+class CowSnapshot;
+
+// Vector whose elements live in an immutable, reference-counted buffer: copies share it in O(1), and the first mutation
+// through a copy that is still shared detaches it with a deep copy. Distinct CowVector objects (and snapshots) sharing a
+// buffer may be used from different threads; a single object needs exclusive access for mutation, like Vector.
+// Elements are only reachable through const references, except via Mutable(), which detaches first
+template <typename T, typename Alloc = std::allocator<T>>
+class CowVector
+{
+public:
+
+    using VectorType = Vector<T, Alloc>;
+    using ValueType = T;
+    using ConstIterator = const T*;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    CowVector() = default;
+
+    explicit CowVector(VectorType&& elements_) : data(std::make_shared<VectorType>(std::move(elements_))) {}
+
+    explicit CowVector(const VectorType& elements_) : data(std::make_shared<VectorType>(elements_)) {}
+
+    CowVector(std::initializer_list<T> init_list_) : data(std::make_shared<VectorType>(init_list_)) {}
+
+    CowVector(const CowVector&) = default;
+    CowVector(CowVector&&) noexcept = default;
+
+    ~CowVector() = default;
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    CowVector& operator=(const CowVector&) = default;
+    CowVector& operator=(CowVector&&) noexcept = default;
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        return Get()[index_];
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    ConstIterator begin() const noexcept
+    {
+        return Get().begin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return Get().end();
+    }
+    ConstIterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    ConstIterator cend() const noexcept
+    {
+        return end();
+    }
+    ConstReverseIterator rbegin() const noexcept
+    {
+        return ConstReverseIterator(end());
+    }
+    ConstReverseIterator rend() const noexcept
+    {
+        return ConstReverseIterator(begin());
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return data ? data->Size() : 0;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return data ? data->Capacity() : 0;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    // True while another CowVector or snapshot refers to the same buffer, i.e. the next mutation copies
+    bool IsShared() const noexcept
+    {
+        return data && data.use_count() > 1;
+    }
+
+    const T& At(size_t index_) const
+    {
+        return Get().At(index_);
+    }
+
+    const T& Front() const noexcept
+    {
+        return Get().Front();
+    }
+
+    const T& Back() const noexcept
+    {
+        return Get().Back();
+    }
+
+    const T* Data() const noexcept
+    {
+        return Get().Data();
+    }
+
+    const VectorType& Get() const noexcept
+    {
+        return data ? *data : Empty();
+    }
+
+    // Read-only view of the current contents; it keeps them alive and unchanged whatever happens to this CowVector later
+    CowSnapshot<T, Alloc> Snapshot() const noexcept
+    {
+        return CowSnapshot<T, Alloc>(data);
+    }
+
+    // Detaches the buffer if it is shared and returns it for in-place modification. The reference is invalidated by
+    // the next copy or snapshot of this CowVector
+    VectorType& Mutable()
+    {
+        if (!data)
+        {
+            data = std::make_shared<VectorType>();
+        }
+        else if (data.use_count() != 1)
+        {
+            data = std::make_shared<VectorType>(*data);
+        }
+        else
+        {
+            // Pairs with the release decrement of the last other owner, so its reads happen before our writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *data;
+    }
+
+    // Drops this CowVector's reference: shared contents are left to their other owners instead of being copied first
+    void Clear() noexcept
+    {
+        data.reset();
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        if (new_capacity_ > Capacity())
+        {
+            Mutable().Reserve(new_capacity_);
+        }
+    }
+
+    void Resize(size_t new_size_)
+    {
+        Mutable().Resize(new_size_);
+    }
+
+    void PopBack()
+    {
+        Mutable().PopBack();
+    }
+
+    ConstIterator Erase(ConstIterator pos_)
+    {
+        return Erase(pos_, pos_ + 1);
+    }
+
+    ConstIterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        // Positions are indices into the (possibly shared) buffer, so they survive the detach
+        const size_t first = first_ - begin();
+        const size_t count = last_ - first_;
+        VectorType& elements = Mutable();
+        return elements.Erase(elements.begin() + first, elements.begin() + first + count);
+    }
+
+    void Swap(CowVector& other_) noexcept
+    {
+        data.swap(other_.data);
+    }
+
+    // Moves the elements out when this CowVector is the only owner, copies them otherwise
+    VectorType Extract() &&
+    {
+        if (!data)
+        {
+            return VectorType();
+        }
+        VectorType elements = data.use_count() == 1 ? std::move(*data) : VectorType(*data);
+        data.reset();
+        return elements;
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename Type>
+    void PushBack(Type&& value_);
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args_);
+
+    template <typename... Args>
+    ConstIterator Emplace(ConstIterator pos_, Args&&... args_);
+
+    template <typename InputIt>
+    void AppendRange(InputIt first_, InputIt last_);
+
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred_);
+
+private:
+
+    template <typename, typename>
+    friend class CowPublisher;
+
+    std::shared_ptr<VectorType> data;
+
+    explicit CowVector(std::shared_ptr<VectorType> data_) noexcept : data(std::move(data_)) {}
+
+    // A private copy of the shared elements with room for extra_ more, so the append that follows does not regrow it
+    std::shared_ptr<VectorType> Detached(size_t extra_) const
+    {
+        auto detached = std::make_shared<VectorType>(std::allocator_traits<Alloc>::select_on_container_copy_construction(data->Allocator()));
+        detached->Reserve(data->Size() + extra_);
+        detached->AppendRange(data->begin(), data->end());
+        return detached;
+    }
+
+    static const VectorType& Empty() noexcept
+    {
+        static const VectorType empty;
+        return empty;
+    }
+};
+
+// Immutable view of one version of a CowVector's contents, cheap to copy and safe to read from any thread
+template <typename T, typename Alloc>
+class CowSnapshot
+{
+public:
+
+    using VectorType = Vector<T, Alloc>;
+    using ValueType = T;
+    using ConstIterator = const T*;
+
+    CowSnapshot() = default;
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        return Get()[index_];
+    }
+
+    ConstIterator begin() const noexcept
+    {
+        return Get().begin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return Get().end();
+    }
+
+    size_t Size() const noexcept
+    {
+        return data ? data->Size() : 0;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    const T& At(size_t index_) const
+    {
+        return Get().At(index_);
+    }
+
+    const T* Data() const noexcept
+    {
+        return Get().Data();
+    }
+
+    const VectorType& Get() const noexcept
+    {
+        static const VectorType empty;
+        return data ? *data : empty;
+    }
+
+    // True when both refer to the same version (not merely equal contents)
+    bool IsSameVersion(const CowSnapshot& other_) const noexcept
+    {
+        return data == other_.data;
+    }
+
+private:
+
+    friend class CowVector<T, Alloc>;
+
+    template <typename, typename>
+    friend class CowPublisher;
+
+    std::shared_ptr<const VectorType> data;
+
+    explicit CowSnapshot(std::shared_ptr<const VectorType> data_) noexcept : data(std::move(data_)) {}
+};
+
+// Holds the current published version for reader threads. Writers prepare a CowVector privately (typically a copy of
+// the current version, changed in place) and publish it with one atomic swap; readers take snapshots concurrently and
+// keep whatever version they got for as long as they need it
+template <typename T, typename Alloc = std::allocator<T>>
+class CowPublisher
+{
+public:
+
+    using VectorType = Vector<T, Alloc>;
+
+    CowPublisher() = default;
+
+    explicit CowPublisher(const CowVector<T, Alloc>& initial_) noexcept : current(initial_.data) {}
+
+    CowPublisher(const CowPublisher&) = delete;
+    CowPublisher& operator=(const CowPublisher&) = delete;
+
+    CowSnapshot<T, Alloc> Snapshot() const noexcept
+    {
+        return CowSnapshot<T, Alloc>(current.load(std::memory_order_acquire));
+    }
+
+    // A CowVector sharing the current version, to be edited (detaching on the first mutation) and published back
+    CowVector<T, Alloc> Checkout() const noexcept
+    {
+        // The published buffer is never written through again, so sharing it as mutable is safe: any CowVector
+        // holding it sees a use count above one and copies before changing anything
+        return CowVector<T, Alloc>(std::const_pointer_cast<VectorType>(current.load(std::memory_order_acquire)));
+    }
+
+    // Makes next_ the current version and returns the one it replaced. next_ keeps sharing the published buffer, so
+    // its own later mutations detach instead of changing what readers see
+    CowSnapshot<T, Alloc> Publish(const CowVector<T, Alloc>& next_) noexcept
+    {
+        return CowSnapshot<T, Alloc>(current.exchange(next_.data, std::memory_order_acq_rel));
+    }
+
+    // Publishes next_ only if expected_ is still the current version, for several writers racing on the same publisher
+    bool CompareAndPublish(const CowSnapshot<T, Alloc>& expected_, const CowVector<T, Alloc>& next_) noexcept
+    {
+        std::shared_ptr<const VectorType> expected = expected_.data;
+        return current.compare_exchange_strong(expected, next_.data, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+private:
+
+    std::atomic<std::shared_ptr<const VectorType>> current;
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename T, typename Alloc>
+template <typename Type>
+void CowVector<T, Alloc>::PushBack(Type&& value_)
+{
+    EmplaceBack(std::forward<Type>(value_));
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+T& CowVector<T, Alloc>::EmplaceBack(Args&&... args_)
+{
+    if (IsShared())
+    {
+        // The arguments may refer into the shared buffer, which stays alive until the copy has been made
+        auto detached = Detached(1);
+        detached->EmplaceBack(std::forward<Args>(args_)...);
+        data = std::move(detached);
+        return data->Back();
+    }
+    return Mutable().EmplaceBack(std::forward<Args>(args_)...);
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+typename CowVector<T, Alloc>::ConstIterator CowVector<T, Alloc>::Emplace(ConstIterator pos_, Args&&... args_)
+{
+    const size_t position = pos_ - begin();
+    // Arguments referring into a shared buffer must not dangle once it is released, so build the element first
+    T value(std::forward<Args>(args_)...);
+    VectorType& elements = Mutable();
+    return elements.Emplace(elements.begin() + position, std::move(value));
+}
+
+template <typename T, typename Alloc>
+template <typename InputIt>
+void CowVector<T, Alloc>::AppendRange(InputIt first_, InputIt last_)
+{
+    if (IsShared())
+    {
+        size_t extra = 0;
+        if constexpr (vector_detail::MultiPassIterator<InputIt>)
+        {
+            extra = std::distance(first_, last_);
+        }
+        auto detached = Detached(extra);
+        detached->AppendRange(first_, last_);
+        data = std::move(detached);
+        return;
+    }
+    Mutable().AppendRange(first_, last_);
+}
+
+template <typename T, typename Alloc>
+template <typename Predicate>
+size_t CowVector<T, Alloc>::EraseIf(Predicate pred_)
+{
+    // Nothing is copied when no element matches
+    if (std::none_of(begin(), end(), pred_))
+    {
+        return 0;
+    }
+    VectorType& elements = Mutable();
+    const size_t old_size = elements.Size();
+    elements.EraseIf(pred_);
+    return old_size - elements.Size();
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename T, typename Alloc>
+inline bool operator==(const CowVector<T, Alloc>& lhs_, const CowVector<T, Alloc>& rhs_)
+{
+    return lhs_.Get() == rhs_.Get();
+}
+template <typename T, typename Alloc>
+inline bool operator!=(const CowVector<T, Alloc>& lhs_, const CowVector<T, Alloc>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
+template <typename T, typename Alloc>
+inline auto operator<=>(const CowVector<T, Alloc>& lhs_, const CowVector<T, Alloc>& rhs_)
+{
+    return lhs_.Get() <=> rhs_.Get();
+}
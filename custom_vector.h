@@ -1,668 +1,2208 @@
 #pragma once
 #include <cassert>
+#include <bit>
+#include <compare>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <concepts>
 #include <new>
 #include <utility>
 #include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include "vector_instrumentation.h"
+#include "vector_parallel.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if __has_include(<jemalloc/jemalloc.h>)
+#include <jemalloc/jemalloc.h>
+#define VECTOR_HAS_NALLOCX 1
+#endif
+
+//------------------------------------------------------------------Relocation Traits--------------------------------------------------------
+
+// Specialize as std::true_type for types whose "move-construct, then destroy the source" is equivalent to copying the bytes
+// (e.g. a handle that owns its resource through a std::unique_ptr)
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
 
 template <typename T>
-class RawMemory
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+namespace vector_detail
 {
-public:
+    // memcpy/memmove of elements is not allowed in constant evaluation, so the bytewise paths are taken at run time only
+    template <typename T>
+    constexpr bool RelocatesBytewise() noexcept
+    {
+        return IsTriviallyRelocatableV<T> && !std::is_constant_evaluated();
+    }
+}
 
-    RawMemory() = default;
+//-------------------------------------------------------------Allocator-Aware Construction Helpers-------------------------------------------
 
-    explicit RawMemory(size_t capacity_) : buffer(Allocate(capacity_)), capacity(capacity_) {}
+namespace vector_detail
+{
+    // Allocators that can resize a block in place (or move it bytewise), e.g. on top of realloc
+    template <typename Alloc>
+    concept ReallocatingAllocator = requires(Alloc& alloc_, typename std::allocator_traits<Alloc>::pointer ptr_, size_t n_)
+    {
+        { alloc_.reallocate(ptr_, n_, n_) } -> std::same_as<typename std::allocator_traits<Alloc>::pointer>;
+    };
 
-    RawMemory(RawMemory&& other_) noexcept
+    // Allocators that can grow or shrink a block where it is (e.g. by committing or releasing pages of a reservation);
+    // resize_in_place(ptr, old_n, new_n) returns false when the block has to move instead
+    template <typename Alloc>
+    concept InPlaceResizingAllocator = requires(Alloc& alloc_, typename std::allocator_traits<Alloc>::pointer ptr_, size_t n_)
     {
-        Swap(other_);
-        other_.buffer = nullptr;
-        other_.capacity = 0;
-    }
+        { alloc_.resize_in_place(ptr_, n_, n_) } -> std::same_as<bool>;
+    };
 
-    RawMemory(const RawMemory&) = delete;
+    // Legacy iterator category check: std::move_iterator only models std::input_iterator in C++20, but it can be measured
+    // with std::distance whenever the iterator it wraps can
+    template <typename It>
+    concept MultiPassIterator = std::derived_from<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
 
-    ~RawMemory()
+    template <typename Growth>
+    concept ShrinkingGrowthPolicy = requires(size_t n_)
     {
-        Deallocate(buffer);
-    }
+        { Growth::ShrinkCapacity(n_, n_) } -> std::convertible_to<size_t>;
+    };
 
-    RawMemory& operator=(const RawMemory&) = delete;
+    // An rvalue range that owns its elements can be moved from; views and other borrowed ranges cannot
+    template <typename Range>
+    inline constexpr bool MovesFromRange = !std::is_lvalue_reference_v<Range> && !std::ranges::borrowed_range<Range>;
 
-    RawMemory& operator=(RawMemory&& rhs_) noexcept
+    template <typename Range>
+    constexpr auto RangeBegin(std::remove_reference_t<Range>& range_)
     {
-        if (this != &rhs_)
+        if constexpr (MovesFromRange<Range>)
         {
-            Swap(rhs_);
+            return std::make_move_iterator(std::ranges::begin(range_));
+        }
+        else
+        {
+            return std::ranges::begin(range_);
         }
-        return *this;
     }
 
-    T* operator+(size_t offset_) noexcept
+    template <typename Range>
+    constexpr auto RangeEnd(std::remove_reference_t<Range>& range_)
     {
-        assert(offset_ <= capacity);
-        return buffer + offset_;
+        if constexpr (MovesFromRange<Range>)
+        {
+            return std::move_sentinel(std::ranges::end(range_));
+        }
+        else
+        {
+            return std::ranges::end(range_);
+        }
     }
 
-    const T* operator+(size_t offset_) const noexcept
+    template <typename Range>
+    constexpr size_t RangeSize(Range& range_)
     {
-        return const_cast<RawMemory&>(*this) + offset_;
+        if constexpr (std::ranges::sized_range<Range>)
+        {
+            return static_cast<size_t>(std::ranges::size(range_));
+        }
+        else
+        {
+            return static_cast<size_t>(std::ranges::distance(range_));
+        }
     }
 
-    const T& operator[](size_t index_) const noexcept
+    // Allocators that report how much they really handed out (the std::allocator::allocate_at_least protocol)
+    template <typename Alloc>
+    concept AllocatesAtLeast = requires(Alloc& alloc_, size_t n_)
     {
-        return const_cast<RawMemory&>(*this)[index_];
+        { alloc_.allocate_at_least(n_).ptr } -> std::convertible_to<typename std::allocator_traits<Alloc>::pointer>;
+        { alloc_.allocate_at_least(n_).count } -> std::convertible_to<size_t>;
+    };
+
+    // Allocators that know how many bytes a block of n elements really occupies, bookkeeping and rounding included
+    template <typename Alloc>
+    concept ReportsFootprint = requires(const Alloc& alloc_, size_t n_)
+    {
+        { alloc_.footprint(n_) } -> std::convertible_to<size_t>;
+    };
+
+    // Number of bytes the C heap actually reserves for a malloc(bytes_) request
+    inline size_t MallocSizeClass(size_t bytes_) noexcept
+    {
+#if defined(VECTOR_HAS_NALLOCX)
+        return bytes_ != 0 ? nallocx(bytes_, 0) : 0;
+#elif defined(__GLIBC__)
+        // glibc: 8 bytes of chunk header, 16-byte granularity, 32-byte minimum chunk; large blocks are mmapped page by page
+        constexpr size_t header = sizeof(size_t);
+        constexpr size_t mmap_threshold = 128 * 1024;
+        constexpr size_t page = 4096;
+        if (bytes_ >= mmap_threshold)
+        {
+            return ((bytes_ + 2 * header + page - 1) & ~(page - 1)) - 2 * header;
+        }
+        return std::max<size_t>(32, (bytes_ + header + 15) & ~size_t(15)) - header;
+#else
+        return (bytes_ + 15) & ~size_t(15);
+#endif
     }
 
-    T& operator[](size_t index_) noexcept
+    // Estimated heap bytes behind a malloc(bytes_) request: the size class plus the chunk header
+    inline size_t MallocFootprint(size_t bytes_) noexcept
     {
-        assert(index_ < capacity);
-        return buffer[index_];
+        return bytes_ != 0 ? MallocSizeClass(bytes_) + sizeof(size_t) : 0;
     }
 
-    void Swap(RawMemory& other_) noexcept
+    template <typename Alloc, typename T, typename... Args>
+    constexpr void Construct(Alloc& alloc_, T* ptr_, Args&&... args_)
     {
-        std::swap(buffer, other_.buffer);
-        std::swap(capacity, other_.capacity);
+        std::allocator_traits<Alloc>::construct(alloc_, ptr_, std::forward<Args>(args_)...);
     }
 
-    const T* GetAddress() const noexcept
+    template <typename Alloc, typename T>
+    constexpr void DestroyN(Alloc& alloc_, T* first_, size_t n_) noexcept
     {
-        return buffer;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (; n_ > 0; --n_, ++first_)
+            {
+                std::allocator_traits<Alloc>::destroy(alloc_, first_);
+            }
+        }
     }
 
-    T* GetAddress() noexcept
+    template <typename Alloc, typename T>
+    constexpr void UninitializedValueConstructN(Alloc& alloc_, T* first_, size_t n_)
     {
-        return buffer;
+        T* current = first_;
+        try
+        {
+            for (; n_ > 0; --n_, ++current)
+            {
+                Construct(alloc_, current);
+            }
+        }
+        catch (...)
+        {
+            DestroyN(alloc_, first_, current - first_);
+            throw;
+        }
     }
 
-    size_t Capacity() const
+    // Default-initialization: trivially default constructible elements are left with whatever bytes the buffer holds
+    template <typename Alloc, typename T>
+    constexpr void UninitializedDefaultConstructN(Alloc& alloc_, T* first_, size_t n_)
     {
-        return capacity;
+        if constexpr (!std::is_trivially_default_constructible_v<T>)
+        {
+            UninitializedValueConstructN(alloc_, first_, n_);
+        }
     }
 
-private:
+    template <typename Alloc, typename InputIt, typename T>
+    constexpr T* UninitializedCopy(Alloc& alloc_, InputIt first_, InputIt last_, T* dest_)
+    {
+        T* current = dest_;
+        try
+        {
+            for (; first_ != last_; ++first_, ++current)
+            {
+                Construct(alloc_, current, *first_);
+            }
+        }
+        catch (...)
+        {
+            DestroyN(alloc_, dest_, current - dest_);
+            throw;
+        }
+        return current;
+    }
 
-    T* buffer = nullptr;
-    size_t capacity = 0;
+    template <typename Alloc, typename InputIt, typename T>
+    constexpr T* UninitializedCopyN(Alloc& alloc_, InputIt first_, size_t n_, T* dest_)
+    {
+        T* current = dest_;
+        try
+        {
+            for (; n_ > 0; --n_, ++first_, ++current)
+            {
+                Construct(alloc_, current, *first_);
+            }
+        }
+        catch (...)
+        {
+            DestroyN(alloc_, dest_, current - dest_);
+            throw;
+        }
+        return current;
+    }
 
-    static T* Allocate(size_t n_)
+    template <typename Alloc, typename T>
+    constexpr T* UninitializedMoveN(Alloc& alloc_, T* first_, size_t n_, T* dest_)
     {
-        return n_ != 0 ? static_cast<T*>(operator new(n_ * sizeof(T))) : nullptr;
+        return UninitializedCopyN(alloc_, std::make_move_iterator(first_), n_, dest_);
     }
 
-    static void Deallocate(T* buf_) noexcept
+    // Moves when that cannot throw (or when T cannot be copied at all), copies otherwise
+    template <typename Alloc, typename T>
+    constexpr T* UninitializedMoveIfNoexceptN(Alloc& alloc_, T* first_, size_t n_, T* dest_)
     {
-        operator delete(buf_);
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        {
+            return UninitializedMoveN(alloc_, first_, n_, dest_);
+        }
+        else
+        {
+            return UninitializedCopyN(alloc_, first_, n_, dest_);
+        }
     }
-};
 
-template <typename T>
-class Vector
-{
-public:
+    // Moves n_ elements from src_ to dest_ and ends the lifetime of the sources, leaving gap_count_ unconstructed
+    // slots in front of src_[gap_pos_]. The sources are destroyed only after every element has arrived
+    template <typename Alloc, typename T>
+    constexpr void UninitializedRelocateN(Alloc& alloc_, T* src_, size_t n_, T* dest_, size_t gap_pos_ = 0, size_t gap_count_ = 0)
+    {
+        assert(gap_pos_ <= n_);
+        if (RelocatesBytewise<T>())
+        {
+            if (gap_pos_ != 0)
+            {
+                std::memcpy(static_cast<void*>(dest_), static_cast<const void*>(src_), gap_pos_ * sizeof(T));
+            }
+            if (n_ != gap_pos_)
+            {
+                std::memcpy(static_cast<void*>(dest_ + gap_pos_ + gap_count_), static_cast<const void*>(src_ + gap_pos_), (n_ - gap_pos_) * sizeof(T));
+            }
+        }
+        else
+        {
+            UninitializedMoveIfNoexceptN(alloc_, src_, gap_pos_, dest_);
+            try
+            {
+                UninitializedMoveIfNoexceptN(alloc_, src_ + gap_pos_, n_ - gap_pos_, dest_ + gap_pos_ + gap_count_);
+            }
+            catch (...)
+            {
+                DestroyN(alloc_, dest_, gap_pos_);
+                throw;
+            }
+            DestroyN(alloc_, src_, n_);
+        }
+    }
 
-    using Iterator = T*;
-    using ConstIterator = const T*;
-    using ReverseIterator = std::reverse_iterator<Iterator>;
-    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+    struct IgnoreMove
+    {
+        template <typename Move>
+        constexpr void operator()(const Move&) const noexcept {}
+    };
 
-    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+    // Output iterator appending through PushBackUnchecked: the container must already have room for everything written
+    template <typename Container>
+    class UncheckedBackInsertIterator
+    {
+    public:
 
-    Vector() = default;
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        constexpr explicit UncheckedBackInsertIterator(Container& container_) noexcept : container(std::addressof(container_)) {}
+
+        constexpr UncheckedBackInsertIterator& operator=(const typename Container::ValueType& value_)
+        {
+            container->PushBackUnchecked(value_);
+            return *this;
+        }
+
+        constexpr UncheckedBackInsertIterator& operator=(typename Container::ValueType&& value_)
+        {
+            container->PushBackUnchecked(std::move(value_));
+            return *this;
+        }
+
+        constexpr UncheckedBackInsertIterator& operator*() noexcept
+        {
+            return *this;
+        }
+
+        constexpr UncheckedBackInsertIterator& operator++() noexcept
+        {
+            return *this;
+        }
+
+        constexpr UncheckedBackInsertIterator operator++(int) noexcept
+        {
+            return *this;
+        }
+
+    private:
+
+        Container* container;
+    };
+
+    // Element types whose operator== is exactly bitwise equality (floating point is left out: -0.0 == 0.0, NaN != NaN)
+    template <typename T>
+    inline constexpr bool IsBitwiseComparableV = std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+    // ...and whose ordering is exactly the unsigned byte order memcmp uses
+    template <typename T>
+    inline constexpr bool IsMemcmpOrderedV = (sizeof(T) == 1 && std::is_unsigned_v<T>) || std::is_same_v<T, std::byte>;
+
+    // Index of the first differing byte, or n_ when the blocks are equal. Vectorized with AVX2/SSE2/NEON where available
+    inline size_t MismatchBytes(const unsigned char* lhs_, const unsigned char* rhs_, size_t n_) noexcept
+    {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= n_; i += 32)
+        {
+            const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs_ + i));
+            const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs_ + i));
+            if (const uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs, rhs))))
+            {
+                return i + std::countr_zero(diff);
+            }
+        }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+        for (; i + 16 <= n_; i += 16)
+        {
+            const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs_ + i));
+            const __m128i rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs_ + i));
+            if (const uint32_t diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs))) & 0xFFFFu)
+            {
+                return i + std::countr_zero(diff);
+            }
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        for (; i + 16 <= n_; i += 16)
+        {
+            // Narrow the 0x00/0xFF lane mask to one nibble per byte so the first mismatch is a countr_zero away
+            const uint8x16_t equal = vceqq_u8(vld1q_u8(lhs_ + i), vld1q_u8(rhs_ + i));
+            const uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+            if (const uint64_t diff = ~nibbles)
+            {
+                return i + std::countr_zero(diff) / 4;
+            }
+        }
+#endif
+        for (; i < n_; ++i)
+        {
+            if (lhs_[i] != rhs_[i])
+            {
+                return i;
+            }
+        }
+        return n_;
+    }
+
+    // Index of the first differing element in [0, n_), or n_
+    template <typename T>
+    size_t MismatchBitwise(const T* lhs_, const T* rhs_, size_t n_) noexcept
+    {
+        return MismatchBytes(reinterpret_cast<const unsigned char*>(lhs_), reinterpret_cast<const unsigned char*>(rhs_), n_ * sizeof(T)) / sizeof(T);
+    }
 
-    explicit Vector(size_t size_) : data(size_), size(size_)
+    template <typename T>
+    constexpr bool RangesEqual(const T* lhs_, size_t lhs_size_, const T* rhs_, size_t rhs_size_)
     {
-        std::uninitialized_value_construct_n(data.GetAddress(), size);
+        if constexpr (IsBitwiseComparableV<T>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return lhs_size_ == rhs_size_ && (lhs_size_ == 0 || std::memcmp(lhs_, rhs_, lhs_size_ * sizeof(T)) == 0);
+            }
+        }
+        return std::equal(lhs_, lhs_ + lhs_size_, rhs_, rhs_ + rhs_size_);
     }
 
-    Vector(const Vector& other_) : data(other_.size), size(other_.size)
+    template <typename T>
+    constexpr bool RangesLess(const T* lhs_, size_t lhs_size_, const T* rhs_, size_t rhs_size_)
     {
-        std::uninitialized_copy_n(other_.data.GetAddress(), size, data.GetAddress());
+        const size_t common = std::min(lhs_size_, rhs_size_);
+        if (!std::is_constant_evaluated())
+        {
+            if constexpr (IsMemcmpOrderedV<T>)
+            {
+                const int result = common != 0 ? std::memcmp(lhs_, rhs_, common) : 0;
+                return result != 0 ? result < 0 : lhs_size_ < rhs_size_;
+            }
+            else if constexpr (IsBitwiseComparableV<T>)
+            {
+                const size_t i = MismatchBitwise(lhs_, rhs_, common);
+                return i != common ? lhs_[i] < rhs_[i] : lhs_size_ < rhs_size_;
+            }
+        }
+        return std::lexicographical_compare(lhs_, lhs_ + lhs_size_, rhs_, rhs_ + rhs_size_);
     }
 
-    Vector(Vector&& other_) noexcept
+    template <typename T>
+    constexpr auto RangesThreeWay(const T* lhs_, size_t lhs_size_, const T* rhs_, size_t rhs_size_)
     {
-        Swap(other_);
+        const size_t common = std::min(lhs_size_, rhs_size_);
+        if (!std::is_constant_evaluated())
+        {
+            if constexpr (IsMemcmpOrderedV<T>)
+            {
+                const int result = common != 0 ? std::memcmp(lhs_, rhs_, common) : 0;
+                return result != 0 ? result <=> 0 : lhs_size_ <=> rhs_size_;
+            }
+            else if constexpr (IsBitwiseComparableV<T>)
+            {
+                const size_t i = MismatchBitwise(lhs_, rhs_, common);
+                return i != common ? lhs_[i] <=> rhs_[i] : lhs_size_ <=> rhs_size_;
+            }
+        }
+        return std::lexicographical_compare_three_way(lhs_, lhs_ + lhs_size_, rhs_, rhs_ + rhs_size_);
     }
+}
+
+template <typename T, typename Alloc = std::allocator<T>>
+class RawMemory
+{
+public:
+
+    using AllocatorType = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
 
-    Vector(std::initializer_list<T> init_list_) : data(init_list_.size()), size(init_list_.size())
+    RawMemory() = default;
+
+    explicit constexpr RawMemory(const Alloc& alloc_) noexcept : allocator(alloc_) {}
+
+    explicit constexpr RawMemory(size_t capacity_, const Alloc& alloc_ = Alloc()) : allocator(alloc_)
     {
-        std::uninitialized_copy(init_list_.begin(), init_list_.end(), data.GetAddress());
+        AllocateBuffer(capacity_);
     }
 
-    ~Vector()
+    constexpr RawMemory(RawMemory&& other_) noexcept
+        : allocator(std::move(other_.allocator))
+        , buffer(std::exchange(other_.buffer, nullptr))
+        , capacity(std::exchange(other_.capacity, 0)) {}
+
+    RawMemory(const RawMemory&) = delete;
+
+    constexpr ~RawMemory()
     {
-        std::destroy_n(data.GetAddress(), size);
+        Deallocate(buffer, capacity);
     }
 
-    //----------------------------------------------------------------------Operators----------------------------------------------------------
+    RawMemory& operator=(const RawMemory&) = delete;
 
-    Vector& operator=(const Vector& rhs_)
+    constexpr RawMemory& operator=(RawMemory&& rhs_) noexcept
     {
         if (this != &rhs_)
         {
-            if (rhs_.size > data.Capacity())
+            Deallocate(buffer, capacity);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
             {
-                Vector rhs_copy(rhs_);
-                Swap(rhs_copy);
+                allocator = std::move(rhs_.allocator);
             }
             else
             {
-                size_t copy_size = std::min(size, rhs_.size);
-                std::copy(rhs_.data.GetAddress(), rhs_.data.GetAddress() + copy_size, data.GetAddress());
-
-                if (rhs_.size < size)
-                {
-                    std::destroy_n(data.GetAddress() + rhs_.size, size - rhs_.size);
-                }
-                else
-                {
-                    std::uninitialized_copy_n(rhs_.data.GetAddress() + size, rhs_.size - size, data.GetAddress() + size);
-                }
-                size = rhs_.size;
+                assert(allocator == rhs_.allocator);
             }
+            buffer = std::exchange(rhs_.buffer, nullptr);
+            capacity = std::exchange(rhs_.capacity, 0);
         }
         return *this;
     }
 
-    Vector& operator=(Vector&& other_) noexcept
+    constexpr T* operator+(size_t offset_) noexcept
     {
-        if (this != &other_)
-        {
-            Swap(other_);
-        }
-        return *this;
+        assert(offset_ <= capacity);
+        return buffer + offset_;
     }
 
-    const T& operator[](size_t index_) const noexcept
+    constexpr const T* operator+(size_t offset_) const noexcept
     {
-        return const_cast<Vector&>(*this)[index_];
+        return const_cast<RawMemory&>(*this) + offset_;
     }
-    T& operator[](size_t index_) noexcept
+
+    constexpr const T& operator[](size_t index_) const noexcept
     {
-        assert(index_ < size);
-        return data[index_];
+        return const_cast<RawMemory&>(*this)[index_];
     }
-    //------------------------------------------------------------------------Iterators---------------------------------------------------------
-    Iterator begin() noexcept
+
+    constexpr T& operator[](size_t index_) noexcept
     {
-        return data.GetAddress();
+        assert(index_ < capacity);
+        return buffer[index_];
     }
-    Iterator end() noexcept
+
+    constexpr void Swap(RawMemory& other_) noexcept
     {
-        return size + data.GetAddress();
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(allocator, other_.allocator);
+        }
+        else
+        {
+            assert(allocator == other_.allocator);
+        }
+        std::swap(buffer, other_.buffer);
+        std::swap(capacity, other_.capacity);
     }
-    ConstIterator cbegin() const noexcept
+
+    // Frees the buffer and adopts alloc_; only valid for allocators that propagate on copy assignment
+    constexpr void Reset(const Alloc& alloc_) noexcept
     {
-        return data.GetAddress();
+        Deallocate(buffer, capacity);
+        buffer = nullptr;
+        capacity = 0;
+        allocator = alloc_;
     }
-    ConstIterator cend() const noexcept
+
+    // Changes the capacity without moving the block; false when the allocator cannot do that for this request
+    constexpr bool ResizeInPlace(size_t new_capacity_) noexcept requires vector_detail::InPlaceResizingAllocator<Alloc>
     {
-        return size + data.GetAddress();
+        if (buffer == nullptr || !allocator.resize_in_place(buffer, capacity, new_capacity_))
+        {
+            return false;
+        }
+        capacity = new_capacity_;
+        return true;
     }
-    ConstIterator begin() const noexcept
+
+    // Resizes the block through the allocator's reallocate hook. Contents are carried over bytewise,
+    // so this is only usable for trivially relocatable T
+    constexpr void Reallocate(size_t new_capacity_) requires vector_detail::ReallocatingAllocator<Alloc>
     {
-        return cbegin();
+        if (new_capacity_ == 0)
+        {
+            Deallocate(buffer, capacity);
+            buffer = nullptr;
+        }
+        else if (buffer == nullptr)
+        {
+            AllocateBuffer(new_capacity_);
+            return;
+        }
+        else
+        {
+            buffer = allocator.reallocate(buffer, capacity, new_capacity_);
+        }
+        capacity = new_capacity_;
     }
-    ConstIterator end() const noexcept
+
+    constexpr const T* GetAddress() const noexcept
     {
-        return cend();
+        return buffer;
     }
-    ReverseIterator rbein() noexcept
+
+    constexpr T* GetAddress() noexcept
     {
-        return ReverseIterator(begin());
+        return buffer;
     }
-    ReverseIterator rend() noexcept
+
+    constexpr size_t Capacity() const
     {
-        return ReverseIterator(end());
+        return capacity;
     }
-    ConstReverseIterator crbegin() const noexcept
+
+    constexpr const Alloc& GetAllocator() const noexcept
+    {
+        return allocator;
+    }
+
+    constexpr Alloc& GetAllocator() noexcept
+    {
+        return allocator;
+    }
+
+private:
+
+    [[no_unique_address]] Alloc allocator = Alloc();
+    T* buffer = nullptr;
+    size_t capacity = 0;
+
+    // The block may come back larger than n_ when the allocator rounds up to its size class
+    constexpr void AllocateBuffer(size_t n_)
+    {
+        if (n_ == 0)
+        {
+            return;
+        }
+        if constexpr (vector_detail::AllocatesAtLeast<Alloc>)
+        {
+            auto result = allocator.allocate_at_least(n_);
+            buffer = result.ptr;
+            capacity = result.count;
+        }
+        else
+        {
+            buffer = AllocTraits::allocate(allocator, n_);
+            capacity = n_;
+        }
+    }
+
+    constexpr void Deallocate(T* buf_, size_t n_) noexcept
+    {
+        if (buf_ != nullptr)
+        {
+            AllocTraits::deallocate(allocator, buf_, n_);
+        }
+    }
+};
+
+// Selects the constructors and resize operations that default-initialize instead of value-initializing new elements
+struct DefaultInitTag
+{
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag DefaultInit{};
+
+// Reported by the unordered erases for every element they move, so callers can fix up external handles
+struct ElementMove
+{
+    size_t from;
+    size_t to;
+};
+
+//--------------------------------------------------------------------Growth Policies-------------------------------------------------------
+// A growth policy maps the current capacity and the number of slots an operation needs to the capacity to allocate
+
+struct DoublingGrowth
+{
+    static constexpr size_t NextCapacity(size_t capacity_, size_t required_, size_t /*element_size_*/) noexcept
+    {
+        return std::max(capacity_ * 2, required_);
+    }
+};
+
+struct OneAndHalfGrowth
+{
+    static constexpr size_t NextCapacity(size_t capacity_, size_t required_, size_t /*element_size_*/) noexcept
+    {
+        return std::max(capacity_ + capacity_ / 2, required_);
+    }
+};
+
+template <size_t Step>
+struct FixedStepGrowth
+{
+    static_assert(Step > 0, "growth step must be positive");
+
+    static constexpr size_t NextCapacity(size_t capacity_, size_t required_, size_t /*element_size_*/) noexcept
+    {
+        return std::max(capacity_ + Step, (required_ + Step - 1) / Step * Step);
+    }
+};
+
+// Applies Base, then stretches the result to fill the malloc size class it lands in, so the slack becomes usable capacity
+template <typename Base = OneAndHalfGrowth>
+struct SizeClassGrowth
+{
+    static size_t NextCapacity(size_t capacity_, size_t required_, size_t element_size_) noexcept
+    {
+        const size_t capacity = Base::NextCapacity(capacity_, required_, element_size_);
+        if (capacity > std::numeric_limits<size_t>::max() / element_size_)
+        {
+            return capacity;
+        }
+        return std::max(capacity, vector_detail::MallocSizeClass(capacity * element_size_) / element_size_);
+    }
+};
+
+// A policy may also define
+//     static size_t ShrinkCapacity(size_t capacity_, size_t size_) noexcept
+// returning a smaller capacity to move to, or capacity_ to keep the buffer. PopBack, the erases, Clear and a shrinking
+// Resize consult it afterwards. A shrink that fails to allocate is skipped, so those operations keep their guarantees
+
+// Adds automatic shrinking to Base: once fewer than OccupancyPercent of the slots are in use, the buffer is shrunk to
+// TargetFactor times the size. The gap between the two thresholds keeps a vector that hovers around one size from
+// reallocating back and forth; buffers of at most MinCapacity elements are never shrunk
+template <typename Base = DoublingGrowth, size_t OccupancyPercent = 25, size_t TargetFactor = 2, size_t MinCapacity = 16>
+struct ShrinkingGrowth : Base
+{
+    static_assert(OccupancyPercent * TargetFactor < 100, "a shrunk buffer must be above the shrink threshold");
+
+    static constexpr size_t ShrinkCapacity(size_t capacity_, size_t size_) noexcept
+    {
+        if (capacity_ <= MinCapacity || size_ * 100 >= capacity_ * OccupancyPercent)
+        {
+            return capacity_;
+        }
+        return std::max(size_ * TargetFactor, MinCapacity);
+    }
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class Vector
+{
+public:
+
+    using AllocatorType = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using GrowthPolicy = Growth;
+    using ValueType = T;
+    using Iterator = T*;
+    using ConstIterator = const T*;
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+    using EmplacePosition = VECTOR_EMPLACE_POSITION(ConstIterator);
+    using UncheckedBackInserter = vector_detail::UncheckedBackInsertIterator<Vector>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    Vector() = default;
+
+    explicit constexpr Vector(const Alloc& alloc_) noexcept : data(alloc_) {}
+
+    explicit constexpr Vector(size_t size_, const Alloc& alloc_ = Alloc()) : data(size_, alloc_)
+    {
+        vector_detail::UninitializedValueConstructN(data.GetAllocator(), data.GetAddress(), size_);
+        size = size_;
+        VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+    }
+
+    constexpr Vector(size_t size_, DefaultInitTag, const Alloc& alloc_ = Alloc()) : data(size_, alloc_)
+    {
+        vector_detail::UninitializedDefaultConstructN(data.GetAllocator(), data.GetAddress(), size_);
+        size = size_;
+        VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+    }
+
+    constexpr Vector(const Vector& other_) : Vector(other_, AllocTraits::select_on_container_copy_construction(other_.data.GetAllocator())) {}
+
+    constexpr Vector(const Vector& other_, const Alloc& alloc_) : data(other_.size, alloc_)
+    {
+        vector_detail::UninitializedCopyN(data.GetAllocator(), other_.data.GetAddress(), other_.size, data.GetAddress());
+        size = other_.size;
+        VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+    }
+
+    // Parallel forms: the elements are constructed chunk by chunk on executor_ (a vector_parallel::Executor or a standard
+    // execution policy), so Alloc::construct must be safe to call from several threads at once
+    template <vector_parallel::ExecutorLike Executor>
+    Vector(size_t size_, Executor&& executor_, const Alloc& alloc_ = Alloc()) : data(size_, alloc_)
+    {
+        ParallelConstructN(executor_, data.GetAllocator(), data.GetAddress(), size_, [this](T* dest_, size_t, size_t n_)
+        {
+            vector_detail::UninitializedValueConstructN(data.GetAllocator(), dest_, n_);
+        });
+        size = size_;
+        VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+    }
+
+    template <vector_parallel::ExecutorLike Executor>
+    Vector(const Vector& other_, Executor&& executor_)
+        : data(other_.size, AllocTraits::select_on_container_copy_construction(other_.data.GetAllocator()))
+    {
+        ParallelConstructN(executor_, data.GetAllocator(), data.GetAddress(), other_.size, [this, &other_](T* dest_, size_t offset_, size_t n_)
+        {
+            vector_detail::UninitializedCopyN(data.GetAllocator(), other_.data.GetAddress() + offset_, n_, dest_);
+        });
+        size = other_.size;
+        VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+    }
+
+    constexpr Vector(Vector&& other_) noexcept : data(std::move(other_.data)), size(std::exchange(other_.size, 0)) {}
+
+    constexpr Vector(Vector&& other_, const Alloc& alloc_) : data(alloc_)
+    {
+        if (alloc_ == other_.data.GetAllocator())
+        {
+            data = std::move(other_.data);
+            size = std::exchange(other_.size, 0);
+        }
+        else
+        {
+            RawMemory<T, Alloc> new_data(other_.size, alloc_);
+            vector_detail::UninitializedMoveN(new_data.GetAllocator(), other_.data.GetAddress(), other_.size, new_data.GetAddress());
+            data = std::move(new_data);
+            size = other_.size;
+            VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+        }
+    }
+
+    constexpr Vector(std::initializer_list<T> init_list_, const Alloc& alloc_ = Alloc()) : data(init_list_.size(), alloc_)
+    {
+        vector_detail::UninitializedCopy(data.GetAllocator(), init_list_.begin(), init_list_.end(), data.GetAddress());
+        size = init_list_.size();
+        VECTOR_INSTRUMENT(RecordAllocation(0, 0));
+    }
+
+    constexpr ~Vector()
+    {
+        vector_detail::DestroyN(data.GetAllocator(), data.GetAddress(), size);
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    constexpr Vector& operator=(const Vector& rhs_)
+    {
+        if (this != &rhs_)
+        {
+            VECTOR_INSTRUMENT(const T* old_buffer = data.GetAddress(); const size_t old_capacity = data.Capacity());
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+            {
+                if (data.GetAllocator() != rhs_.data.GetAllocator())
+                {
+                    ClearKeepingCapacity();
+                    data.Reset(rhs_.data.GetAllocator());
+                }
+            }
+
+            if (rhs_.size > data.Capacity() && !ResizeInPlace(rhs_.size))
+            {
+                RawMemory<T, Alloc> new_data(rhs_.size, data.GetAllocator());
+                vector_detail::UninitializedCopyN(new_data.GetAllocator(), rhs_.data.GetAddress(), rhs_.size, new_data.GetAddress());
+                vector_detail::DestroyN(data.GetAllocator(), data.GetAddress(), size);
+                data.Swap(new_data);
+            }
+            else
+            {
+                size_t copy_size = std::min(size, rhs_.size);
+                std::copy(rhs_.data.GetAddress(), rhs_.data.GetAddress() + copy_size, data.GetAddress());
+
+                if (rhs_.size < size)
+                {
+                    vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + rhs_.size, size - rhs_.size);
+                }
+                else
+                {
+                    vector_detail::UninitializedCopyN(data.GetAllocator(), rhs_.data.GetAddress() + size, rhs_.size - size, data.GetAddress() + size);
+                }
+            }
+            size = rhs_.size;
+            VECTOR_INSTRUMENT(if (data.GetAddress() != old_buffer) { RecordAllocation(old_capacity, 0); });
+        }
+        return *this;
+    }
+
+    constexpr Vector& operator=(Vector&& other_) noexcept(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+    {
+        if (this != &other_)
+        {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+            {
+                ClearKeepingCapacity();
+                data = std::move(other_.data);
+                size = std::exchange(other_.size, 0);
+            }
+            else if (data.GetAllocator() == other_.data.GetAllocator())
+            {
+                ClearKeepingCapacity();
+                data = std::move(other_.data);
+                size = std::exchange(other_.size, 0);
+            }
+            else
+            {
+                // Unequal allocators that do not propagate: the buffer cannot change hands, so move element-wise
+                Assign(std::make_move_iterator(other_.begin()), std::make_move_iterator(other_.end()));
+            }
+        }
+        return *this;
+    }
+
+    constexpr const T& operator[](size_t index_) const noexcept
+    {
+        return const_cast<Vector&>(*this)[index_];
+    }
+    constexpr T& operator[](size_t index_) noexcept
+    {
+        assert(index_ < size);
+        return data[index_];
+    }
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+    constexpr Iterator begin() noexcept
+    {
+        return data.GetAddress();
+    }
+    constexpr Iterator end() noexcept
+    {
+        return size + data.GetAddress();
+    }
+    constexpr ConstIterator cbegin() const noexcept
+    {
+        return data.GetAddress();
+    }
+    constexpr ConstIterator cend() const noexcept
+    {
+        return size + data.GetAddress();
+    }
+    constexpr ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    constexpr ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+    constexpr ReverseIterator rbein() noexcept
+    {
+        return ReverseIterator(begin());
+    }
+    constexpr ReverseIterator rend() noexcept
+    {
+        return ReverseIterator(end());
+    }
+    constexpr ConstReverseIterator crbegin() const noexcept
+    {
+        return ConstReverseIterator(cend());
+    }
+
+    constexpr ConstReverseIterator crend() const noexcept
+    {
+        return ConstReverseIterator(cbegin());
+    }
+
+    constexpr ConstReverseIterator rbegin() const noexcept
+    {
+        return crbegin();
+    }
+
+    constexpr ConstReverseIterator rend() const noexcept
+    {
+        return crend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    constexpr size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    constexpr size_t Capacity() const noexcept
+    {
+        return data.Capacity();
+    }
+
+    constexpr Alloc Allocator() const noexcept
+    {
+        return data.GetAllocator();
+    }
+
+    constexpr size_t MaxSize() const
+    {
+        return AllocTraits::max_size(data.GetAllocator());
+    }
+
+    constexpr bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    constexpr void Clear() noexcept
+    {
+        ClearKeepingCapacity();
+        ApplyShrinkPolicy();
+    }
+
+    // Destroys the elements but keeps the buffer whatever the growth policy says, for callers that refill or replace it next
+    constexpr void ClearKeepingCapacity() noexcept
+    {
+        vector_detail::DestroyN(data.GetAllocator(), data.GetAddress(), size);
+        size = 0;
+    }
+
+    // Heap bytes held by the buffer: Capacity() * sizeof(T) plus what the allocator adds on top (size-class rounding and
+    // chunk header for malloc-based allocators, unless the allocator reports its own footprint)
+    constexpr size_t MemoryFootprint() const noexcept
+    {
+        if (data.Capacity() == 0)
+        {
+            return 0;
+        }
+        if constexpr (vector_detail::ReportsFootprint<Alloc>)
+        {
+            return data.GetAllocator().footprint(data.Capacity());
+        }
+        else
+        {
+            return std::is_constant_evaluated() ? data.Capacity() * sizeof(T) : vector_detail::MallocFootprint(data.Capacity() * sizeof(T));
+        }
+    }
+
+    constexpr T& Front() noexcept
+    {
+        assert(size > 0);
+        return data[0];
+    }
+
+    constexpr const T& Front() const noexcept
+    {
+        assert(size > 0);
+        return data[0];
+    }
+
+    constexpr T& Back() noexcept
+    {
+        assert(size > 0);
+        return data[size - 1];
+    }
+
+    constexpr const T& Back() const noexcept
+    {
+        assert(size > 0);
+        return data[size - 1];
+    }
+
+    constexpr Iterator Data() noexcept
+    {
+        return data.GetAddress();
+    }
+
+    constexpr ConstIterator Data() const noexcept
+    {
+        return data.GetAddress();
+    }
+
+    constexpr T& At(size_t index_)
+    {
+        assert(index_ < size);
+        return data[index_];
+    }
+
+    constexpr const T& At(size_t index_) const
+    {
+        assert(index_ < size);
+        return data[index_];
+    }
+
+    constexpr void Swap(Vector& other_) noexcept
+    {
+        data.Swap(other_.data);
+        std::swap(size, other_.size);
+    }
+
+    constexpr void Reserve(size_t new_capacity_ VECTOR_CALL_SITE_TAG)
+    {
+
+        if (new_capacity_ <= data.Capacity())
+        {
+            return;
+        }
+
+        Reallocate(new_capacity_ VECTOR_CALL_SITE_FORWARD);
+    }
+
+    // The uninitialized slots between Size() and Capacity(), for external writers (read, recv, io_uring completions);
+    // CommitSize then makes the filled prefix part of the vector. Only for types whose objects a byte copy can create
+    constexpr std::span<T> SpareCapacity() noexcept requires std::is_trivially_copyable_v<T>
+    {
+        return std::span<T>(data.GetAddress() + size, data.Capacity() - size);
+    }
+
+    // Grows with the growth policy first when fewer than min_count_ slots are spare
+    constexpr std::span<T> SpareCapacity(size_t min_count_ VECTOR_CALL_SITE_TAG) requires std::is_trivially_copyable_v<T>
+    {
+        if (data.Capacity() - size < min_count_)
+        {
+            Reallocate(GrownCapacity(size + min_count_) VECTOR_CALL_SITE_FORWARD);
+        }
+        return SpareCapacity();
+    }
+
+    // Appends the first count_ spare slots, which the caller has filled
+    constexpr void CommitSize(size_t count_) noexcept requires std::is_trivially_copyable_v<T>
+    {
+        assert(count_ <= data.Capacity() - size);
+        size += count_;
+    }
+
+    // For filling capacity set aside with Reserve: the iterator appends without checking for room
+    constexpr UncheckedBackInserter BackInserter() noexcept
+    {
+        return UncheckedBackInserter(*this);
+    }
+
+    constexpr void Resize(size_t new_size_)
+    {
+        if (new_size_ < size)
+        {
+            vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + new_size_, size - new_size_);
+            size = new_size_;
+            ApplyShrinkPolicy();
+        }
+        else
+        {
+            if (new_size_ > data.Capacity())
+            {
+                Reserve(GrownCapacity(new_size_));
+            }
+            vector_detail::UninitializedValueConstructN(data.GetAllocator(), data.GetAddress() + size, new_size_ - size);
+            size = new_size_;
+        }
+    }
+
+    // Like Resize, but new trivially default constructible elements are not zeroed; meant for buffers that are overwritten next
+    constexpr void ResizeForOverwrite(size_t new_size_)
+    {
+        if (new_size_ < size)
+        {
+            vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + new_size_, size - new_size_);
+            size = new_size_;
+            ApplyShrinkPolicy();
+        }
+        else
+        {
+            if (new_size_ > data.Capacity())
+            {
+                Reserve(GrownCapacity(new_size_));
+            }
+            vector_detail::UninitializedDefaultConstructN(data.GetAllocator(), data.GetAddress() + size, new_size_ - size);
+            size = new_size_;
+        }
+    }
+
+    constexpr void ShrinkToFit()
+    {
+        if (size != data.Capacity())
+        {
+            ShrinkTo(size);
+        }
+    }
+
+    // Reallocates only when more than slack_ slots are unused, and then keeps slack_ of them
+    constexpr void ShrinkToFit(size_t slack_)
+    {
+        if (data.Capacity() - size > slack_)
+        {
+            ShrinkTo(size + slack_);
+        }
+    }
+
+    constexpr void Assign(std::initializer_list<T> ilist_)
+    {
+        Assign(ilist_.begin(), ilist_.end());
+    }
+
+    constexpr Iterator Insert(ConstIterator pos_, const T& item_)
+    {
+        return Emplace(pos_, item_);
+    }
+    constexpr Iterator Insert(ConstIterator pos_, T&& item_)
+    {
+        return Emplace(pos_, std::move(item_));
+    }
+
+    constexpr Iterator Erase(ConstIterator pos_)
+    {
+        assert(pos_ >= begin() && pos_ < end());
+        int position = pos_ - begin();
+
+        std::move(begin() + position + 1, end(), begin() + position);
+        vector_detail::DestroyN(data.GetAllocator(), end() - 1, 1);
+        size -= 1;
+        ApplyShrinkPolicy();
+
+        return (begin() + position);
+    }
+
+    constexpr Iterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        assert(first_ >= begin() && first_ <= last_ && last_ <= end());
+        const size_t position = first_ - begin();
+        const size_t count = last_ - first_;
+        T* gap = data.GetAddress() + position;
+
+        if (count == 0)
+        {
+            return begin() + position;
+        }
+
+        if (vector_detail::RelocatesBytewise<T>())
+        {
+            vector_detail::DestroyN(data.GetAllocator(), gap, count);
+            std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), (size - position - count) * sizeof(T));
+        }
+        else
+        {
+            std::move(gap + count, data.GetAddress() + size, gap);
+            vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + size - count, count);
+        }
+        size -= count;
+        ApplyShrinkPolicy();
+
+        return begin() + position;
+    }
+
+    // Removes the elements at strictly increasing indices in one pass: each run of survivors is shifted once and the
+    // vacated tail is destroyed once. Returns the number of erased elements
+    constexpr size_t EraseIndices(std::span<const size_t> sorted_indices_)
+    {
+        if (sorted_indices_.empty())
+        {
+            return 0;
+        }
+        assert(std::adjacent_find(sorted_indices_.begin(), sorted_indices_.end(), std::greater_equal<>()) == sorted_indices_.end());
+        assert(sorted_indices_.back() < size);
+
+        T* base = data.GetAddress();
+        size_t write = sorted_indices_[0];
+        for (size_t k = 0; k < sorted_indices_.size(); ++k)
+        {
+            const size_t read = sorted_indices_[k] + 1;
+            const size_t stop = k + 1 < sorted_indices_.size() ? sorted_indices_[k + 1] : size;
+            if (vector_detail::RelocatesBytewise<T>())
+            {
+                vector_detail::DestroyN(data.GetAllocator(), base + sorted_indices_[k], 1);
+                std::memmove(static_cast<void*>(base + write), static_cast<const void*>(base + read), (stop - read) * sizeof(T));
+            }
+            else
+            {
+                std::move(base + read, base + stop, base + write);
+            }
+            write += stop - read;
+        }
+        if (!vector_detail::RelocatesBytewise<T>())
+        {
+            vector_detail::DestroyN(data.GetAllocator(), base + write, size - write);
+        }
+
+        const size_t erased = size - write;
+        size = write;
+        ApplyShrinkPolicy();
+        return erased;
+    }
+
+    // O(1) erase that does not keep the order: Back() is moved into the hole. Returns the old and the new index of the
+    // moved element; from == to when the erased element was the last one and nothing moved
+    constexpr ElementMove EraseUnordered(ConstIterator pos_)
+    {
+        assert(pos_ >= begin() && pos_ < end());
+        const size_t position = pos_ - begin();
+        const size_t last = size - 1;
+
+        if (position != last)
+        {
+            data[position] = std::move(data[last]);
+        }
+        PopBack();
+
+        return { last, position };
+    }
+
+    constexpr void PopBack()
+    {
+        assert(size);
+        vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + size - 1, 1);
+        --size;
+        ApplyShrinkPolicy();
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args_);
+
+    template <typename... Args>
+    constexpr Iterator Emplace(EmplacePosition pos_, Args&&... args_);
+
+    template <typename Type>
+    constexpr void PushBack(Type&& value_ VECTOR_CALL_SITE_TAG);
+
+    // Appends without the capacity check; the caller guarantees Size() < Capacity(), e.g. after Reserve
+    template <typename... Args>
+    constexpr T& EmplaceBackUnchecked(Args&&... args_);
+
+    template <typename Type>
+    constexpr void PushBackUnchecked(Type&& value_);
+
+    template <typename InputIt>
+    constexpr void Assign(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    constexpr void AppendRange(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    constexpr Iterator InsertRange(ConstIterator pos_, InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    constexpr void AssignRange(InputIt first_, InputIt last_);
+
+    // Range overloads: sized or multi-pass ranges are measured once, single-pass ones are consumed as they go,
+    // and elements are moved out of rvalue owning ranges
+    template <std::ranges::input_range Range>
+    constexpr void AppendRange(Range&& range_);
+
+    template <std::ranges::input_range Range>
+    constexpr Iterator InsertRange(ConstIterator pos_, Range&& range_);
+
+    template <std::ranges::input_range Range>
+    constexpr void AssignRange(Range&& range_);
+
+    template <typename Predicate>
+    constexpr void EraseIf(Predicate pred_);
+
+    // Order-breaking EraseIf: holes are filled from the back, so only survivors beyond the new Size() move, each once.
+    // on_move_(ElementMove) is called for every moved element. Returns the number of erased elements
+    template <typename Predicate, typename OnMove = vector_detail::IgnoreMove>
+    constexpr size_t EraseIfUnordered(Predicate pred_, OnMove on_move_ = {});
+
+    // Removes every element whose mask_[i] is set (std::bitset, std::vector<bool>, ...); mask_.size() must cover Size()
+    template <typename Mask>
+    constexpr size_t EraseMask(const Mask& mask_);
+
+    template <typename Operation>
+    constexpr void ResizeAndOverwrite(size_t new_size_, Operation op_);
+
+    // Copy assignment with the copies (or assignments) done chunk by chunk on executor_
+    template <vector_parallel::ExecutorLike Executor>
+    void ParallelAssign(const Vector& rhs_, Executor&& executor_);
+
+    // Resize with the new elements value-initialized chunk by chunk on executor_. A fresh block is first touched by the
+    // workers, so with a first-touch policy (the default, or NumaAllocator with NumaPolicy::Local) each page lands on the
+    // node of the worker that will process it, given the same executor later, e.g. a pinned StaticThreadExecutor.
+    // Elements already present are relocated by the calling thread when the buffer grows
+    template <vector_parallel::ExecutorLike Executor>
+    void Resize(size_t new_size_, Executor&& executor_);
+
+    // EraseIf with the predicate evaluated in parallel: every chunk is compacted in place, then the compacted runs are
+    // shifted down to their prefix-sum offsets. pred_ is called concurrently. Returns the number of erased elements
+    template <typename Predicate, vector_parallel::ExecutorLike Executor>
+    size_t ParallelEraseIf(Predicate pred_, Executor&& executor_);
+
+private:
+
+    RawMemory<T, Alloc> data;
+    size_t size = 0;
+
+    // Every growing operation asks the policy here, so the growth rule is the same everywhere
+    constexpr size_t GrownCapacity(size_t required_) const noexcept
+    {
+        return std::min(std::max(Growth::NextCapacity(data.Capacity(), required_, sizeof(T)), required_), MaxSize());
+    }
+
+    template <typename Executor, typename Construct>
+    static void ParallelConstructN(Executor& executor_, Alloc& alloc_, T* dest_, size_t count_, Construct construct_);
+
+    template <typename Executor>
+    static void ParallelDestroyN(Executor& executor_, Alloc& alloc_, T* first_, size_t count_);
+
+    template <typename It>
+    constexpr void AssignCounted(It first_, size_t count_);
+
+    template <typename It>
+    constexpr void AppendCounted(It first_, size_t count_);
+
+    template <typename It, typename Sentinel>
+    constexpr void AppendUnsized(It first_, Sentinel last_);
+
+    template <typename It>
+    constexpr Iterator InsertCounted(size_t position_, It first_, size_t count_);
+
+    template <typename It, typename Sentinel>
+    constexpr Iterator InsertUnsized(size_t position_, It first_, Sentinel last_);
+
+    static constexpr bool ReallocatesInPlace = IsTriviallyRelocatableV<T> && vector_detail::ReallocatingAllocator<Alloc>;
+
+    // Grows or shrinks the block without moving it, for allocators with a resize_in_place hook; false when that is not
+    // possible and the caller has to relocate
+    constexpr bool ResizeInPlace(size_t new_capacity_ VECTOR_CALL_SITE_UNTAGGED)
+    {
+        if constexpr (vector_detail::InPlaceResizingAllocator<Alloc>)
+        {
+            VECTOR_INSTRUMENT(const size_t old_capacity = data.Capacity());
+            if (data.ResizeInPlace(new_capacity_))
+            {
+                VECTOR_INSTRUMENT(RecordAllocation(old_capacity, 0 VECTOR_CALL_SITE_FORWARD));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Out-of-line slow path of PushBack/EmplaceBack, taken only when the buffer is full
+    template <typename... Args>
+    [[gnu::noinline, gnu::cold]] constexpr T& GrowAndEmplaceBack(VECTOR_INSTRUMENT(std::source_location call_site_,) Args&&... args_)
+    {
+        const size_t new_capacity = GrownCapacity(size + 1);
+        if (ResizeInPlace(new_capacity VECTOR_CALL_SITE_FORWARD))
+        {
+            // The block stays where it is, so arguments referring into it are still valid
+            vector_detail::Construct(data.GetAllocator(), data.GetAddress() + size, std::forward<Args>(args_)...);
+        }
+        else if constexpr (ReallocatesInPlace)
+        {
+            // The arguments may refer into the buffer that realloc is about to release
+            T value(std::forward<Args>(args_)...);
+            Reallocate(new_capacity VECTOR_CALL_SITE_FORWARD);
+            vector_detail::Construct(data.GetAllocator(), data.GetAddress() + size, std::move(value));
+        }
+        else
+        {
+            RawMemory<T, Alloc> new_data(new_capacity, data.GetAllocator());
+
+            vector_detail::Construct(new_data.GetAllocator(), new_data.GetAddress() + size, std::forward<Args>(args_)...);
+
+            try
+            {
+                vector_detail::UninitializedRelocateN(data.GetAllocator(), data.GetAddress(), size, new_data.GetAddress());
+            }
+            catch (...)
+            {
+                vector_detail::DestroyN(new_data.GetAllocator(), new_data.GetAddress() + size, 1);
+                throw;
+            }
+            data.Swap(new_data);
+            VECTOR_INSTRUMENT(RecordAllocation(new_data.Capacity(), size VECTOR_CALL_SITE_FORWARD));
+        }
+        return data[size++];
+    }
+
+    // Moves to a smaller buffer (none at all for 0), in place when the allocator can
+    constexpr void ShrinkTo(size_t new_capacity_)
+    {
+        if (ResizeInPlace(new_capacity_))
+        {
+            return;
+        }
+        if (new_capacity_ == 0)
+        {
+            data = RawMemory<T, Alloc>(data.GetAllocator());
+        }
+        else
+        {
+            Reallocate(new_capacity_);
+        }
+    }
+
+    // Called by every operation that lowers the size; a no-op unless the growth policy defines ShrinkCapacity
+    constexpr void ApplyShrinkPolicy() noexcept
+    {
+        if constexpr (vector_detail::ShrinkingGrowthPolicy<Growth>)
+        {
+            const size_t new_capacity = Growth::ShrinkCapacity(data.Capacity(), size);
+            if (new_capacity < data.Capacity())
+            {
+                try
+                {
+                    ShrinkTo(std::max(new_capacity, size));
+                }
+                catch (...)
+                {
+                    // Keeping the larger buffer is always correct
+                }
+            }
+        }
+    }
+
+    // Moves the elements into a buffer of new_capacity_ slots: realloc when the allocator supports it, otherwise a fresh block
+    constexpr void Reallocate(size_t new_capacity_ VECTOR_CALL_SITE_UNTAGGED)
+    {
+        if (ResizeInPlace(new_capacity_ VECTOR_CALL_SITE_FORWARD))
+        {
+            return;
+        }
+        VECTOR_INSTRUMENT(const size_t old_capacity = data.Capacity());
+        if constexpr (ReallocatesInPlace)
+        {
+            data.Reallocate(new_capacity_);
+        }
+        else
+        {
+            RawMemory<T, Alloc> new_data(new_capacity_, data.GetAllocator());
+            vector_detail::UninitializedRelocateN(data.GetAllocator(), data.GetAddress(), size, new_data.GetAddress());
+            data.Swap(new_data);
+        }
+        VECTOR_INSTRUMENT(RecordAllocation(old_capacity, size VECTOR_CALL_SITE_FORWARD));
+    }
+
+#if defined(VECTOR_ENABLE_INSTRUMENTATION)
+    constexpr void RecordAllocation(size_t old_capacity_, size_t relocated_count_, std::source_location call_site_ = std::source_location()) const
+    {
+        if (!std::is_constant_evaluated() && data.Capacity() != 0)
+        {
+            vector_instrumentation::Record<Vector>(old_capacity_, data.Capacity(), size, relocated_count_, call_site_);
+        }
+    }
+#endif
+};
+
+namespace pmr
+{
+    template <typename T, typename Growth = DoublingGrowth>
+    using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, Growth>;
+}
+
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+template <typename T, typename Alloc, typename Growth>
+template <typename Type>
+constexpr void Vector<T, Alloc, Growth>::PushBack(Type&& value_ VECTOR_CALL_SITE_PARAM)
+{
+    if (size < data.Capacity()) [[likely]]
+    {
+        vector_detail::Construct(data.GetAllocator(), data.GetAddress() + size, std::forward<Type>(value_));
+        ++size;
+    }
+    else
+    {
+        GrowAndEmplaceBack(VECTOR_INSTRUMENT(call_site_,) std::forward<Type>(value_));
+    }
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+constexpr T& Vector<T, Alloc, Growth>::EmplaceBack(Args&&... args_)
+{
+    if (size < data.Capacity()) [[likely]]
+    {
+        T* slot = data.GetAddress() + size;
+        vector_detail::Construct(data.GetAllocator(), slot, std::forward<Args>(args_)...);
+        ++size;
+        return *slot;
+    }
+    return GrowAndEmplaceBack(VECTOR_INSTRUMENT(std::source_location(),) std::forward<Args>(args_)...);
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+constexpr T& Vector<T, Alloc, Growth>::EmplaceBackUnchecked(Args&&... args_)
+{
+    assert(size < data.Capacity());
+    T* slot = data.GetAddress() + size;
+    vector_detail::Construct(data.GetAllocator(), slot, std::forward<Args>(args_)...);
+    ++size;
+    return *slot;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename Type>
+constexpr void Vector<T, Alloc, Growth>::PushBackUnchecked(Type&& value_)
+{
+    EmplaceBackUnchecked(std::forward<Type>(value_));
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename... Args>
+constexpr Vector<T, Alloc, Growth>::Iterator Vector<T, Alloc, Growth>::Emplace(EmplacePosition pos_, Args&&... args_)
+{
+    VECTOR_INSTRUMENT(const std::source_location call_site_ = pos_.call_site);
+    assert(pos_ >= begin() && pos_ <= end());
+    int position = pos_ - begin();
+
+    if (data.Capacity() <= size && !ResizeInPlace(GrownCapacity(size + 1)))
+    {
+        if constexpr (ReallocatesInPlace)
+        {
+            T value(std::forward<Args>(args_)...);
+            Reallocate(GrownCapacity(size + 1) VECTOR_CALL_SITE_FORWARD);
+            std::memmove(static_cast<void*>(data.GetAddress() + position + 1), static_cast<const void*>(data.GetAddress() + position), (size - position) * sizeof(T));
+            vector_detail::Construct(data.GetAllocator(), data.GetAddress() + position, std::move(value));
+        }
+        else
+        {
+            RawMemory<T, Alloc> new_data(GrownCapacity(size + 1), data.GetAllocator());
+
+            vector_detail::Construct(new_data.GetAllocator(), new_data.GetAddress() + position, std::forward<Args>(args_)...);
+
+            try
+            {
+                vector_detail::UninitializedRelocateN(data.GetAllocator(), data.GetAddress(), size, new_data.GetAddress(), position, 1);
+            }
+            catch (...)
+            {
+                vector_detail::DestroyN(new_data.GetAllocator(), new_data.GetAddress() + position, 1);
+                throw;
+            }
+            data.Swap(new_data);
+            VECTOR_INSTRUMENT(RecordAllocation(new_data.Capacity(), size VECTOR_CALL_SITE_FORWARD));
+        }
+    }
+    else if (pos_ == end())
+    {
+        vector_detail::Construct(data.GetAllocator(), end(), std::forward<Args>(args_)...);
+    }
+    else if (vector_detail::RelocatesBytewise<T>())
+    {
+        // Build the element in raw storage first (the arguments may refer into the tail), then relocate it into the gap
+        alignas(T) unsigned char slot[sizeof(T)];
+        vector_detail::Construct(data.GetAllocator(), reinterpret_cast<T*>(slot), std::forward<Args>(args_)...);
+        T* gap = data.GetAddress() + position;
+        std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), (size - position) * sizeof(T));
+        std::memcpy(static_cast<void*>(gap), static_cast<const void*>(slot), sizeof(T));
+    }
+    else
+    {
+        T* gap = data.GetAddress() + position;
+        T* old_end = data.GetAddress() + size;
+        if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...))
+        {
+            // A lone T argument is assigned straight into the gap, unless it lives in the part of the tail being shifted
+            // (unrelated pointers cannot be ordered in constant evaluation, so there it always takes the temporary)
+            const T& arg = (args_, ...);
+            if (!std::is_constant_evaluated() && (std::addressof(arg) < gap || std::addressof(arg) >= old_end))
+            {
+                vector_detail::Construct(data.GetAllocator(), old_end, std::move(old_end[-1]));
+                ++size;
+                std::move_backward(gap, old_end - 1, old_end);
+                *gap = (std::forward<Args>(args_), ...);
+                return begin() + position;
+            }
+        }
+        T new_s(std::forward<Args>(args_)...);
+        vector_detail::Construct(data.GetAllocator(), old_end, std::move(old_end[-1]));
+        ++size;
+        std::move_backward(gap, old_end - 1, old_end);
+        *gap = std::move(new_s);
+        return begin() + position;
+    }
+    size++;
+    return begin() + position;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename InputIt>
+constexpr void Vector<T, Alloc, Growth>::Assign(InputIt first_, InputIt last_)
+{
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
     {
-        return ConstReverseIterator(cend());
+        AssignCounted(first_, std::distance(first_, last_));
     }
-
-    ConstReverseIterator crend() const noexcept
+    else
     {
-        return ConstReverseIterator(cbegin());
+        ClearKeepingCapacity();
+        AppendUnsized(first_, last_);
     }
+}
 
-    ConstReverseIterator rbegin() const noexcept
+template <typename T, typename Alloc, typename Growth>
+template <typename InputIt>
+constexpr void Vector<T, Alloc, Growth>::AppendRange(InputIt first_, InputIt last_)
+{
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
     {
-        return crbegin();
+        AppendCounted(first_, std::distance(first_, last_));
     }
-
-    ConstReverseIterator rend() const noexcept
+    else
     {
-        return crend();
+        AppendUnsized(first_, last_);
     }
+}
 
-    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+template <typename T, typename Alloc, typename Growth>
+template <typename InputIt>
+constexpr Vector<T, Alloc, Growth>::Iterator Vector<T, Alloc, Growth>::InsertRange(ConstIterator pos_, InputIt first_, InputIt last_)
+{
+    assert(pos_ >= begin() && pos_ <= end());
 
-    size_t Size() const noexcept
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
     {
-        return size;
+        return InsertCounted(pos_ - begin(), first_, std::distance(first_, last_));
     }
-
-    size_t Capacity() const noexcept
+    else
     {
-        return data.Capacity();
+        return InsertUnsized(pos_ - begin(), first_, last_);
     }
+}
 
-    std::allocator<T> Allocator() const noexcept
-    {
-        return std::allocator<T>();
-    }
+template <typename T, typename Alloc, typename Growth>
+template <typename InputIt>
+constexpr void Vector<T, Alloc, Growth>::AssignRange(InputIt first_, InputIt last_)
+{
+    Assign(first_, last_);
+}
 
-    size_t MaxSize() const
+template <typename T, typename Alloc, typename Growth>
+template <std::ranges::input_range Range>
+constexpr void Vector<T, Alloc, Growth>::AppendRange(Range&& range_)
+{
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>)
     {
-        return std::numeric_limits<size_t>::max / sizeof(T);
+        AppendCounted(vector_detail::RangeBegin<Range>(range_), vector_detail::RangeSize(range_));
     }
-
-    bool IsEmpty() const noexcept
+    else
     {
-        return size == 0;
+        AppendUnsized(vector_detail::RangeBegin<Range>(range_), vector_detail::RangeEnd<Range>(range_));
     }
+}
 
-    void Clear() noexcept
+template <typename T, typename Alloc, typename Growth>
+template <std::ranges::input_range Range>
+constexpr void Vector<T, Alloc, Growth>::AssignRange(Range&& range_)
+{
+    if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>)
     {
-        std::destroy_n(data.GetAddress(), size);
-        size = 0;
+        AssignCounted(vector_detail::RangeBegin<Range>(range_), vector_detail::RangeSize(range_));
     }
-
-    T& Front() noexcept
+    else
     {
-        assert(size > 0);
-        return data[0];
+        ClearKeepingCapacity();
+        AppendUnsized(vector_detail::RangeBegin<Range>(range_), vector_detail::RangeEnd<Range>(range_));
     }
+}
 
-    const T& Front() const noexcept
+template <typename T, typename Alloc, typename Growth>
+template <std::ranges::input_range Range>
+constexpr Vector<T, Alloc, Growth>::Iterator Vector<T, Alloc, Growth>::InsertRange(ConstIterator pos_, Range&& range_)
+{
+    assert(pos_ >= begin() && pos_ <= end());
+
+    // InsertCounted may read the elements twice, so only multi-pass ranges go there
+    if constexpr (std::ranges::forward_range<Range>)
     {
-        assert(size > 0);
-        return data[0];
+        return InsertCounted(pos_ - begin(), vector_detail::RangeBegin<Range>(range_), vector_detail::RangeSize(range_));
     }
-
-    T& Back() noexcept
+    else if constexpr (std::ranges::sized_range<Range>)
     {
-        assert(size > 0);
-        return data[size - 1];
+        // A sized single-pass range is appended in one counted pass, then rotated into place
+        const size_t position = pos_ - begin();
+        const size_t old_size = size;
+        AppendCounted(vector_detail::RangeBegin<Range>(range_), vector_detail::RangeSize(range_));
+        std::rotate(begin() + position, begin() + old_size, end());
+        return begin() + position;
     }
-
-    const T& Back() const noexcept
+    else
     {
-        assert(size > 0);
-        return data[size - 1];
+        return InsertUnsized(pos_ - begin(), vector_detail::RangeBegin<Range>(range_), vector_detail::RangeEnd<Range>(range_));
     }
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+constexpr void Vector<T, Alloc, Growth>::AssignCounted(It first_, size_t count_)
+{
+    ClearKeepingCapacity();
+    VECTOR_INSTRUMENT(const T* old_buffer = data.GetAddress(); const size_t old_capacity = data.Capacity());
 
-    Iterator Data() noexcept
+    if (count_ > data.Capacity() && !ResizeInPlace(count_))
     {
-        return data.GetAddress();
+        RawMemory<T, Alloc> new_data(count_, data.GetAllocator());
+        vector_detail::UninitializedCopyN(new_data.GetAllocator(), first_, count_, new_data.GetAddress());
+        data.Swap(new_data);
     }
-
-    ConstIterator Data() const noexcept
+    else
     {
-        return data.GetAddress();
+        vector_detail::UninitializedCopyN(data.GetAllocator(), first_, count_, data.GetAddress());
     }
+    size = count_;
+    VECTOR_INSTRUMENT(if (data.GetAddress() != old_buffer) { RecordAllocation(old_capacity, 0); });
+}
 
-    T& At(size_t index_)
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+constexpr void Vector<T, Alloc, Growth>::AppendCounted(It first_, size_t count_)
+{
+    if (size + count_ > data.Capacity())
     {
-        assert(index_ < size);
-        return data[index_];
+        Reserve(GrownCapacity(size + count_));
     }
+    vector_detail::UninitializedCopyN(data.GetAllocator(), first_, count_, data.GetAddress() + size);
+    size += count_;
+}
 
-    const T& At(size_t index_) const
+// Single pass: the length is unknown up front, so the buffer grows through the policy as elements arrive
+template <typename T, typename Alloc, typename Growth>
+template <typename It, typename Sentinel>
+constexpr void Vector<T, Alloc, Growth>::AppendUnsized(It first_, Sentinel last_)
+{
+    for (; first_ != last_; ++first_)
     {
-        assert(index_ < size);
-        return data[index_];
+        EmplaceBack(*first_);
     }
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename It>
+constexpr Vector<T, Alloc, Growth>::Iterator Vector<T, Alloc, Growth>::InsertCounted(size_t position_, It first_, size_t count_)
+{
+    const size_t position = position_;
+    const size_t new_elements_count = count_;
 
-    void Swap(Vector& other_) noexcept
+    if (new_elements_count == 0)
     {
-        data.Swap(other_.data);
-        std::swap(size, other_.size);
+        return begin() + position;
     }
 
-    void Reserve(size_t new_capacity_)
+    if (size + new_elements_count > data.Capacity() && !ResizeInPlace(GrownCapacity(size + new_elements_count)))
     {
+        RawMemory<T, Alloc> new_data(GrownCapacity(size + new_elements_count), data.GetAllocator());
+        Alloc& new_alloc = new_data.GetAllocator();
+        T* new_buf = new_data.GetAddress();
 
-        if (new_capacity_ <= data.Capacity())
+        vector_detail::UninitializedCopyN(new_alloc, first_, new_elements_count, new_buf + position);
+        try
         {
-            return;
+            vector_detail::UninitializedRelocateN(data.GetAllocator(), data.GetAddress(), size, new_buf, position, new_elements_count);
         }
-
-        RawMemory<T> new_data(new_capacity_);
-
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        catch (...)
         {
-            std::uninitialized_move_n(data.GetAddress(), size, new_data.GetAddress());
+            vector_detail::DestroyN(new_alloc, new_buf + position, new_elements_count);
+            throw;
         }
-        else
+        data.Swap(new_data);
+        VECTOR_INSTRUMENT(RecordAllocation(new_data.Capacity(), size));
+        size += new_elements_count;
+    }
+    else if (vector_detail::RelocatesBytewise<T>())
+    {
+        // Shift the tail with one memmove, then construct straight into the gap; on failure the tail is shifted back
+        T* gap = data.GetAddress() + position;
+        const size_t tail = size - position;
+        std::memmove(static_cast<void*>(gap + new_elements_count), static_cast<const void*>(gap), tail * sizeof(T));
+        try
         {
-            std::uninitialized_copy_n(data.GetAddress(), size, new_data.GetAddress());
+            vector_detail::UninitializedCopyN(data.GetAllocator(), first_, new_elements_count, gap);
         }
-
-        std::destroy_n(data.GetAddress(), size);
-        data.Swap(new_data);
+        catch (...)
+        {
+            std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + new_elements_count), tail * sizeof(T));
+            throw;
+        }
+        size += new_elements_count;
     }
-
-    void Resize(size_t new_size_)
+    else
     {
-        if (new_size_ < size)
+        // Only the part of the tail that lands past end() is move-constructed; the rest is move-assigned in place
+        T* gap = data.GetAddress() + position;
+        T* old_end = data.GetAddress() + size;
+        const size_t tail = size - position;
+
+        if (tail > new_elements_count)
         {
-            std::destroy_n(data.GetAddress() + new_size_, size - new_size_);
+            vector_detail::UninitializedMoveN(data.GetAllocator(), old_end - new_elements_count, new_elements_count, old_end);
+            size += new_elements_count;
+            std::move_backward(gap, old_end - new_elements_count, old_end);
+            std::copy_n(first_, new_elements_count, gap);
         }
         else
         {
-            if (new_size_ > data.Capacity())
+            It middle = std::ranges::next(first_, tail);
+            vector_detail::UninitializedCopyN(data.GetAllocator(), middle, new_elements_count - tail, old_end);
+            try
             {
-                const size_t new_capacity = std::max(data.Capacity() * 2, new_size_);
-
-                Reserve(new_capacity);
+                vector_detail::UninitializedMoveN(data.GetAllocator(), gap, tail, gap + new_elements_count);
+            }
+            catch (...)
+            {
+                vector_detail::DestroyN(data.GetAllocator(), old_end, new_elements_count - tail);
+                throw;
             }
-            std::uninitialized_value_construct_n(data.GetAddress() + size, new_size_ - size);
+            size += new_elements_count;
+            std::copy_n(first_, tail, gap);
         }
-        size = new_size_;
     }
+    return begin() + position;
+}
+
+// Appends the single-pass input at the end, then rotates it into place
+template <typename T, typename Alloc, typename Growth>
+template <typename It, typename Sentinel>
+constexpr Vector<T, Alloc, Growth>::Iterator Vector<T, Alloc, Growth>::InsertUnsized(size_t position_, It first_, Sentinel last_)
+{
+    const size_t old_size = size;
+    AppendUnsized(std::move(first_), last_);
+    std::rotate(begin() + position_, begin() + old_size, end());
+    return begin() + position_;
+}
+
+template <typename T, typename Alloc, typename Growth>
+template <typename Predicate>
+constexpr void Vector<T, Alloc, Growth>::EraseIf(Predicate pred_)
+{
+    auto new_end = std::remove_if(begin(), end(), pred_);
+    vector_detail::DestroyN(data.GetAllocator(), new_end, end() - new_end);
+    size = std::distance(begin(), new_end);
+    ApplyShrinkPolicy();
+}
 
-    void ShrinkToFit()
+template <typename T, typename Alloc, typename Growth>
+template <typename Predicate, typename OnMove>
+constexpr size_t Vector<T, Alloc, Growth>::EraseIfUnordered(Predicate pred_, OnMove on_move_)
+{
+    T* base = data.GetAddress();
+    size_t low = 0;
+    size_t high = size;
+    for (;;)
     {
-        if (size == data.Capacity())
+        while (low < high && !pred_(std::as_const(base[low])))
         {
-            return;
+            ++low;
         }
-        if (size == 0)
+        if (low == high)
         {
-            data = RawMemory<T>();
+            break;
         }
-        else
+        // base[low] is a hole; look for the last survivor above it
+        --high;
+        while (low < high && pred_(std::as_const(base[high])))
         {
-            RawMemory<T> new_data(size);
-            std::uninitialized_move_n(data.GetAddress(), size, new_data.GetAddress());
-            data.Swap(new_data);
+            --high;
         }
+        if (low == high)
+        {
+            break;
+        }
+        base[low] = std::move(base[high]);
+        on_move_(ElementMove{ high, low });
+        ++low;
     }
+    vector_detail::DestroyN(data.GetAllocator(), base + low, size - low);
 
-    void Assign(std::initializer_list<T> ilist_)
-    {
-        Assign(ilist_.begin(), ilist_.end());
-    }
-
-    Iterator Insert(ConstIterator pos_, const T& item_)
-    {
-        return Emplace(pos_, item_);
-    }
-    Iterator Insert(ConstIterator pos_, T&& item_)
-    {
-        return Emplace(pos_, std::move(item_));
-    }
-
-    Iterator Erase(ConstIterator pos_)
-    {
-        assert(pos_ >= begin() && pos_ < end());
-        int position = pos_ - begin();
-
-        std::move(begin() + position + 1, end(), begin() + position);
-        std::destroy_at(end() - 1);
-        size -= 1;
+    const size_t erased = size - low;
+    size = low;
+    ApplyShrinkPolicy();
+    return erased;
+}
 
-        return (begin() + position);
-    }
+template <typename T, typename Alloc, typename Growth>
+template <typename Mask>
+constexpr size_t Vector<T, Alloc, Growth>::EraseMask(const Mask& mask_)
+{
+    assert(mask_.size() >= size);
 
-    void PopBack()
+    T* base = data.GetAddress();
+    size_t write = 0;
+    for (size_t read = 0; read < size; ++read)
     {
-        assert(size);
-        std::destroy_at(data.GetAddress() + size - 1);
-        --size;
+        if (!mask_[read])
+        {
+            if (write != read)
+            {
+                base[write] = std::move(base[read]);
+            }
+            ++write;
+        }
     }
+    vector_detail::DestroyN(data.GetAllocator(), base + write, size - write);
 
-    //------------------------------------------------------------------Template Metods----------------------------------------------------------
-
-    template <typename... Args>
-    T& EmplaceBack(Args&&... args_);
-
-    template <typename... Args>
-    Iterator Emplace(ConstIterator pos_, Args&&... args_);
-
-    template <typename Type>
-    void PushBack(Type&& value_);
-
-    template <typename InputIt>
-    void Assign(InputIt first_, InputIt last_);
-
-    template <typename InputIt>
-    void AppendRange(InputIt first_, InputIt last_);
-
-    template <typename InputIt>
-    Iterator InsertRange(ConstIterator pos_, InputIt first_, InputIt last_);
-
-    template <typename InputIt>
-    void AssignRange(InputIt first_, InputIt last_);
-
-    template <typename Predicate>
-    void EraseIf(Predicate pred_);
-
-private:
-
-    RawMemory<T> data;
-    size_t size = 0;
-};
-
+    const size_t erased = size - write;
+    size = write;
+    ApplyShrinkPolicy();
+    return erased;
+}
 
-//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
-template <typename T>
-template <typename Type>
-void Vector<T>::PushBack(Type&& value_)
+// Fills dest_[0, count_) through construct_(first_, offset_, n_), one chunk per task; if any chunk throws, every chunk that
+// completed is destroyed again before the exception propagates
+template <typename T, typename Alloc, typename Growth>
+template <typename Executor, typename Construct>
+void Vector<T, Alloc, Growth>::ParallelConstructN(Executor& executor_, Alloc& alloc_, T* dest_, size_t count_, Construct construct_)
 {
-    if (data.Capacity() <= size)
+    const size_t chunk = vector_parallel::ChunkElements<T>();
+    std::vector<unsigned char> done((count_ + chunk - 1) / chunk, 0);
+    try
     {
-        RawMemory<T> new_data(size == 0 ? 1 : size * 2);
-
-        new (new_data.GetAddress() + size) T(std::forward<Type>(value_));
-
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-        {
-            std::uninitialized_move_n(data.GetAddress(), size, new_data.GetAddress());
-        }
-        else
+        vector_parallel::ForEachChunk<T>(executor_, count_, [&](size_t first_, size_t n_)
         {
-            std::uninitialized_copy_n(data.GetAddress(), size, new_data.GetAddress());
-        }
-        std::destroy_n(data.GetAddress(), size);
-        data.Swap(new_data);
+            construct_(dest_ + first_, first_, n_);
+            done[first_ / chunk] = 1;
+        });
     }
-    else
+    catch (...)
     {
-        new (data.GetAddress() + size) T(std::forward<Type>(value_));
+        for (size_t i = 0; i < done.size(); ++i)
+        {
+            if (done[i])
+            {
+                vector_detail::DestroyN(alloc_, dest_ + i * chunk, std::min(chunk, count_ - i * chunk));
+            }
+        }
+        throw;
     }
-    size++;
 }
 
-template <typename T>
-template <typename... Args>
-T& Vector<T>::EmplaceBack(Args&&... args_)
+template <typename T, typename Alloc, typename Growth>
+template <typename Executor>
+void Vector<T, Alloc, Growth>::ParallelDestroyN(Executor& executor_, Alloc& alloc_, T* first_, size_t count_)
 {
-    Emplace(end(), std::forward<Args>(args_)...);
-    return data[size - 1];
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        vector_parallel::ForEachChunk<T>(executor_, count_, [&](size_t offset_, size_t n_)
+        {
+            vector_detail::DestroyN(alloc_, first_ + offset_, n_);
+        });
+    }
 }
 
-template <typename T>
-template <typename... Args>
-Vector<T>::Iterator Vector<T>::Emplace(ConstIterator pos_, Args&&... args_)
+template <typename T, typename Alloc, typename Growth>
+template <vector_parallel::ExecutorLike Executor>
+void Vector<T, Alloc, Growth>::ParallelAssign(const Vector& rhs_, Executor&& executor_)
 {
-    assert(pos_ >= begin() && pos_ <= end());
-    int position = pos_ - begin();
-
-    if (data.Capacity() <= size)
+    if (this == &rhs_)
     {
-        RawMemory<T> new_data(size == 0 ? 1 : size * 2);
-
-        new (new_data.GetAddress() + position) T(std::forward<Args>(args_)...);
-
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        return;
+    }
+    VECTOR_INSTRUMENT(const T* old_buffer = data.GetAddress(); const size_t old_capacity = data.Capacity());
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+    {
+        if (data.GetAllocator() != rhs_.data.GetAllocator())
         {
-            std::uninitialized_move_n(data.GetAddress(), position, new_data.GetAddress());
-            std::uninitialized_move_n(data.GetAddress() + position, size - position, new_data.GetAddress() + position + 1);
+            ClearKeepingCapacity();
+            data.Reset(rhs_.data.GetAllocator());
         }
-        else
+    }
+
+    const T* source = rhs_.data.GetAddress();
+    if (rhs_.size > data.Capacity() && !ResizeInPlace(rhs_.size))
+    {
+        RawMemory<T, Alloc> new_data(rhs_.size, data.GetAllocator());
+        ParallelConstructN(executor_, new_data.GetAllocator(), new_data.GetAddress(), rhs_.size, [&new_data, source](T* dest_, size_t offset_, size_t n_)
         {
-            std::uninitialized_copy_n(data.GetAddress(), position, new_data.GetAddress());
-            std::uninitialized_copy_n(data.GetAddress() + position, size - position, new_data.GetAddress() + position + 1);
-        }
-        std::destroy_n(data.GetAddress(), size);
+            vector_detail::UninitializedCopyN(new_data.GetAllocator(), source + offset_, n_, dest_);
+        });
+        ParallelDestroyN(executor_, data.GetAllocator(), data.GetAddress(), size);
         data.Swap(new_data);
     }
     else
     {
-        try
+        const size_t copy_size = std::min(size, rhs_.size);
+        T* dest = data.GetAddress();
+        vector_parallel::ForEachChunk<T>(executor_, copy_size, [dest, source](size_t offset_, size_t n_)
         {
-            if (pos_ != end())
-            {
-                T new_s(std::forward<Args>(args_)...);
-                new (end()) T(std::forward<T>(data[size - 1]));
+            std::copy_n(source + offset_, n_, dest + offset_);
+        });
 
-                std::move_backward(begin() + position, end() - 1, end());
-                *(begin() + position) = std::forward<T>(new_s);
-            }
-            else
-            {
-                new (end()) T(std::forward<Args>(args_)...);
-            }
+        if (rhs_.size < size)
+        {
+            ParallelDestroyN(executor_, data.GetAllocator(), dest + rhs_.size, size - rhs_.size);
         }
-        catch (...)
+        else
         {
-            operator delete (end());
-            throw;
+            ParallelConstructN(executor_, data.GetAllocator(), dest + size, rhs_.size - size, [this, source](T* dest_, size_t offset_, size_t n_)
+            {
+                vector_detail::UninitializedCopyN(data.GetAllocator(), source + size + offset_, n_, dest_);
+            });
         }
     }
-    size++;
-    return begin() + position;
+    size = rhs_.size;
+    VECTOR_INSTRUMENT(if (data.GetAddress() != old_buffer) { RecordAllocation(old_capacity, 0); });
 }
 
-template<typename T>
-template <typename InputIt>
-void Vector<T>::Assign(InputIt first_, InputIt last_)
+template <typename T, typename Alloc, typename Growth>
+template <vector_parallel::ExecutorLike Executor>
+void Vector<T, Alloc, Growth>::Resize(size_t new_size_, Executor&& executor_)
 {
-    Clear();
-
-    size_t new_size = std::distance(first_, last_);
-    if (new_size > data.Capacity())
+    if (new_size_ < size)
     {
-        RawMemory<T> new_data(new_size);
-        std::uninitialized_copy(first_, last_, new_data.GetAddress());
-        data.Swap(new_data);
+        ParallelDestroyN(executor_, data.GetAllocator(), data.GetAddress() + new_size_, size - new_size_);
+        size = new_size_;
+        ApplyShrinkPolicy();
+        return;
     }
-    else
+    if (new_size_ > data.Capacity())
     {
-        std::uninitialized_copy(first_, last_, data.GetAddress());
+        Reserve(GrownCapacity(new_size_));
     }
-    size = new_size;
-}
-
-template<typename T>
-template <typename InputIt>
-void Vector<T>::AppendRange(InputIt first_, InputIt last_)
-{
-    size_t new_elements_count = std::distance(first_, last_);
-    if (size + new_elements_count > data.Capacity())
+    ParallelConstructN(executor_, data.GetAllocator(), data.GetAddress() + size, new_size_ - size, [this](T* dest_, size_t, size_t n_)
     {
-        Reserve(std::max(data.Capacity() * 2, size + new_elements_count));
-    }
-    std::uninitialized_copy(first_, last_, data.GetAddress() + size);
-    size += new_elements_count;
+        vector_detail::UninitializedValueConstructN(data.GetAllocator(), dest_, n_);
+    });
+    size = new_size_;
 }
 
-template<typename T>
-template <typename InputIt>
-Vector<T>::Iterator Vector<T>::InsertRange(ConstIterator pos_, InputIt first_, InputIt last_)
+template <typename T, typename Alloc, typename Growth>
+template <typename Predicate, vector_parallel::ExecutorLike Executor>
+size_t Vector<T, Alloc, Growth>::ParallelEraseIf(Predicate pred_, Executor&& executor_)
 {
-    assert(pos_ >= begin() && pos_ <= end());
-
-    size_t position = pos_ - begin();
-    size_t new_elements_count = std::distance(first_, last_);
+    const size_t chunk = vector_parallel::ChunkElements<T>();
+    const size_t chunks = (size + chunk - 1) / chunk;
+    T* base = data.GetAddress();
 
-    if (size + new_elements_count > data.Capacity())
+    // Every chunk drops its own victims and records how many survivors it kept at its front
+    std::vector<size_t> kept(chunks, 0);
+    vector_parallel::ForEachChunk<T>(executor_, size, [&](size_t first_, size_t n_)
     {
-        RawMemory<T> new_data(std::max(data.Capacity() * 2, size + new_elements_count));
-        std::uninitialized_copy(data.GetAddress(), data.GetAddress() + position, new_data.GetAddress());
-        std::uninitialized_copy(first_, last_, new_data.GetAddress() + position);
-        std::uninitialized_copy(data.GetAddress() + position, data.GetAddress() + size, new_data.GetAddress() + position + new_elements_count);
-        std::destroy_n(data.GetAddress(), size);
-        data.Swap(new_data);
-    }
-    else
+        kept[first_ / chunk] = std::remove_if(base + first_, base + first_ + n_, pred_) - (base + first_);
+    });
+
+    // The runs must move in order: a run's destination can overlap the source of the run before it
+    size_t write = chunks != 0 ? kept[0] : 0;
+    for (size_t i = 1; i < chunks; ++i)
     {
-        std::move_backward(begin() + position, end(), end() + new_elements_count);
-        std::copy(first_, last_, begin() + position);
+        T* run = base + i * chunk;
+        if (base + write != run)
+        {
+            std::move(run, run + kept[i], base + write);
+        }
+        write += kept[i];
     }
-    size += new_elements_count;
-    return begin() + position;
+    ParallelDestroyN(executor_, data.GetAllocator(), base + write, size - write);
+
+    const size_t erased = size - write;
+    size = write;
+    ApplyShrinkPolicy();
+    return erased;
 }
 
-template<typename T>
-template <typename InputIt>
-void Vector<T>::AssignRange(InputIt first_, InputIt last_)
+// Grows to at most new_size_ default-initialized elements and lets op_(Data(), new_size_) fill them; op_ returns how many
+// elements are valid afterwards (like std::basic_string::resize_and_overwrite)
+template <typename T, typename Alloc, typename Growth>
+template <typename Operation>
+constexpr void Vector<T, Alloc, Growth>::ResizeAndOverwrite(size_t new_size_, Operation op_)
 {
-    Clear();
-    size_t new_size = std::distance(first_, last_);
-    if (new_size > data.Capacity())
+    const size_t old_size = size;
+    if (new_size_ > old_size)
     {
-        RawMemory<T> new_data(new_size);
-        std::uninitialized_copy(first_, last_, new_data.GetAddress());
-        data.Swap(new_data);
+        if (new_size_ > data.Capacity())
+        {
+            Reserve(GrownCapacity(new_size_));
+        }
+        vector_detail::UninitializedDefaultConstructN(data.GetAllocator(), data.GetAddress() + old_size, new_size_ - old_size);
+        size = new_size_;
     }
-    else
+
+    size_t written;
+    try
     {
-        std::uninitialized_copy(first_, last_, data.GetAddress());
+        written = static_cast<size_t>(std::move(op_)(data.GetAddress(), new_size_));
     }
-    size = new_size;
-}
+    catch (...)
+    {
+        if (size > old_size)
+        {
+            vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + old_size, size - old_size);
+            size = old_size;
+        }
+        throw;
+    }
+    assert(written <= new_size_);
 
-template<typename T>
-template <typename Predicate>
-void Vector<T>::EraseIf(Predicate pred_)
-{
-    auto new_end = std::remove_if(begin(), end(), pred_);
-    std::destroy(new_end, end());
-    size = std::distance(begin(), new_end);
+    vector_detail::DestroyN(data.GetAllocator(), data.GetAddress() + written, size - written);
+    size = written;
 }
 
 //-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
 
-template<typename T>
-inline bool operator==(const Vector<T>& lhs_, const Vector<T>& rhs_)
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator==(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_)
 {
-    return std::equal(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+    return vector_detail::RangesEqual(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
 }
-template<typename T>
-inline bool operator!=(const Vector<T>& lhs_, const Vector<T>& rhs_)
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator!=(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_)
 {
     return !(lhs_ == rhs_);
 }
-template<typename T>
-inline bool operator<(const Vector<T>& lhs_, const Vector<T>& rhs_)
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator<(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_)
 {
-    return std::lexicographical_compare(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+    return vector_detail::RangesLess(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
 }
-template<typename T>
-inline bool operator<=(const Vector<T>& lhs_, const Vector<T>& rhs_)
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator<=(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_)
 {
     return !(rhs_ < lhs_);
 }
-template<typename T>
-inline bool operator>(const Vector<T>& lhs_, const Vector<T>& rhs_)
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator>(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_)
 {
-    return (lhs_ <= rhs_);
+    return rhs_ < lhs_;
 }
-template<typename T>
-inline bool operator>=(const Vector<T>& lhs_, const Vector<T>& rhs_)
+template <typename T, typename Alloc, typename Growth>
+constexpr bool operator>=(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_)
 {
     return !(lhs_ < rhs_);
 }
-template<typename T>
-constexpr auto operator<=>(const Vector<T>& lhs_, const Vector<T>& rhs_) /* return std::strong_ordering | std::weak_ordering | std::partial_ordering */
+template <typename T, typename Alloc, typename Growth>
+constexpr auto operator<=>(const Vector<T, Alloc, Growth>& lhs_, const Vector<T, Alloc, Growth>& rhs_) /* return std::strong_ordering | std::weak_ordering | std::partial_ordering */
 {
-    return std::lexicographical_compare_three_way(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+    return vector_detail::RangesThreeWay(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
 }
\ No newline at end of file
@@ -0,0 +1,507 @@
+#pragma once
+#include "flat_set.h"
+#include <span>
+#include <tuple>
+#include <utility>
+
+// Sorted map of unique keys stored as two parallel Vectors, so key searches only touch the key column and values can be
+// scanned as one contiguous span. Dereferencing an iterator yields a std::pair<const K&, V&> proxy. InsertBatch works
+// like FlatSet's: append, sort the new tail, merge it in once. All iterators are invalidated by every modification
+template <typename K, typename V, typename Compare = std::less<K>, typename Search = BranchlessSearch>
+class FlatMap
+{
+public:
+
+    using KeyType = K;
+    using MappedType = V;
+    using KeyCompare = Compare;
+    using SearchPolicy = Search;
+    using Reference = std::pair<const K&, V&>;
+    using ConstReference = std::pair<const K&, const V&>;
+
+    template <bool IsConst>
+    class BasicIterator
+    {
+    public:
+
+        // Dereferencing yields a proxy, so this is only an input iterator for the standard algorithms
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, ConstReference, Reference>;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(std::conditional_t<IsConst, const FlatMap*, FlatMap*> owner_, size_t index_) noexcept : owner(owner_), index(index_) {}
+
+        // Iterator -> ConstIterator
+        template <bool OtherConst> requires (IsConst && !OtherConst)
+        BasicIterator(const BasicIterator<OtherConst>& other_) noexcept : owner(other_.owner), index(other_.index) {}
+
+        reference operator*() const noexcept
+        {
+            return reference(owner->keys[index], owner->values[index]);
+        }
+
+        const K& Key() const noexcept
+        {
+            return owner->keys[index];
+        }
+
+        auto& Value() const noexcept
+        {
+            return owner->values[index];
+        }
+
+        size_t Index() const noexcept
+        {
+            return index;
+        }
+
+        BasicIterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+        BasicIterator operator++(int) noexcept
+        {
+            BasicIterator copy = *this;
+            ++index;
+            return copy;
+        }
+
+        friend BasicIterator operator+(BasicIterator it_, difference_type offset_) noexcept
+        {
+            it_.index += offset_;
+            return it_;
+        }
+        friend difference_type operator-(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return static_cast<difference_type>(lhs_.index) - static_cast<difference_type>(rhs_.index);
+        }
+
+        friend bool operator==(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index == rhs_.index;
+        }
+        friend auto operator<=>(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index <=> rhs_.index;
+        }
+
+    private:
+
+        template <bool>
+        friend class BasicIterator;
+
+        std::conditional_t<IsConst, const FlatMap*, FlatMap*> owner = nullptr;
+        size_t index = 0;
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp_) : comp(comp_) {}
+
+    FlatMap(std::initializer_list<std::pair<K, V>> init_list_, const Compare& comp_ = Compare()) : comp(comp_)
+    {
+        InsertBatch(init_list_.begin(), init_list_.end());
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    // Value-initializes the value of a missing key
+    V& operator[](const K& key_)
+    {
+        return *TryEmplace(key_).first;
+    }
+
+    V& operator[](K&& key_)
+    {
+        return *TryEmplace(std::move(key_)).first;
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Iterator(this, 0);
+    }
+    Iterator end() noexcept
+    {
+        return Iterator(this, keys.Size());
+    }
+    ConstIterator begin() const noexcept
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator end() const noexcept
+    {
+        return ConstIterator(this, keys.Size());
+    }
+    ConstIterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    ConstIterator cend() const noexcept
+    {
+        return end();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return keys.Size();
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return keys.IsEmpty();
+    }
+
+    // The sorted key column
+    const Vector<K>& Keys() const noexcept
+    {
+        return keys;
+    }
+
+    // The value column, in key order; values may be changed in place, since they do not affect the order
+    std::span<V> Values() noexcept
+    {
+        return std::span<V>(values.Data(), values.Size());
+    }
+
+    std::span<const V> Values() const noexcept
+    {
+        return std::span<const V>(values.Data(), values.Size());
+    }
+
+    const Compare& KeyComp() const noexcept
+    {
+        return comp;
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        keys.Reserve(new_capacity_);
+        values.Reserve(new_capacity_);
+    }
+
+    void ShrinkToFit()
+    {
+        keys.ShrinkToFit();
+        values.ShrinkToFit();
+    }
+
+    void Clear() noexcept
+    {
+        keys.Clear();
+        values.Clear();
+        RebuildSearch();
+    }
+
+    // Index of the key in the sorted columns, or Size() when it is missing
+    size_t IndexOf(const K& key_) const noexcept
+    {
+        const size_t index = LowerBoundIndex(key_);
+        return index != keys.Size() && !comp(key_, keys[index]) ? index : keys.Size();
+    }
+
+    Iterator Find(const K& key_) noexcept
+    {
+        return Iterator(this, IndexOf(key_));
+    }
+
+    ConstIterator Find(const K& key_) const noexcept
+    {
+        return ConstIterator(this, IndexOf(key_));
+    }
+
+    Iterator LowerBound(const K& key_) noexcept
+    {
+        return Iterator(this, LowerBoundIndex(key_));
+    }
+
+    ConstIterator LowerBound(const K& key_) const noexcept
+    {
+        return ConstIterator(this, LowerBoundIndex(key_));
+    }
+
+    bool Contains(const K& key_) const noexcept
+    {
+        return IndexOf(key_) != keys.Size();
+    }
+
+    V& At(const K& key_)
+    {
+        const size_t index = IndexOf(key_);
+        assert(index != keys.Size());
+        return values[index];
+    }
+
+    const V& At(const K& key_) const
+    {
+        const size_t index = IndexOf(key_);
+        assert(index != keys.Size());
+        return values[index];
+    }
+
+    size_t Erase(const K& key_)
+    {
+        const size_t index = IndexOf(key_);
+        if (index == keys.Size())
+        {
+            return 0;
+        }
+        Erase(ConstIterator(this, index));
+        return 1;
+    }
+
+    Iterator Erase(ConstIterator pos_)
+    {
+        return Erase(pos_, pos_ + 1);
+    }
+
+    Iterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        const size_t first = first_.Index();
+        const size_t last = last_.Index();
+        keys.Erase(keys.begin() + first, keys.begin() + last);
+        values.Erase(values.begin() + first, values.begin() + last);
+        RebuildSearch();
+        return Iterator(this, first);
+    }
+
+    void Swap(FlatMap& other_) noexcept(std::is_nothrow_swappable_v<Compare> && std::is_nothrow_swappable_v<Search>)
+    {
+        keys.Swap(other_.keys);
+        values.Swap(other_.values);
+        std::swap(comp, other_.comp);
+        std::swap(search, other_.search);
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    // Inserts key_ with a value built from args_ unless the key is present; returns the key's value and whether it was added
+    template <typename Key, typename... Args>
+    std::pair<V*, bool> TryEmplace(Key&& key_, Args&&... args_);
+
+    template <typename Key, typename Value>
+    std::pair<V*, bool> InsertOrAssign(Key&& key_, Value&& value_);
+
+    // Inserts every (key, value) pair of the range whose key is not present yet (the first of equivalent keys in the
+    // range wins). Returns the number of pairs added
+    template <typename InputIt>
+    size_t InsertBatch(InputIt first_, InputIt last_);
+
+    template <std::ranges::input_range Range>
+    size_t InsertBatch(Range&& range_);
+
+    // pred_(const K&, const V&)
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred_);
+
+private:
+
+    Vector<K> keys;
+    Vector<V> values;
+    [[no_unique_address]] Compare comp;
+    [[no_unique_address]] Search search;
+
+    size_t LowerBoundIndex(const K& key_) const noexcept
+    {
+        return search.LowerBound(keys.Data(), keys.Size(), key_, comp);
+    }
+
+    void RebuildSearch()
+    {
+        search.Rebuild(keys.Data(), keys.Size());
+    }
+
+    size_t MergeTail(size_t old_size_);
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename K, typename V, typename Compare, typename Search>
+template <typename Key, typename... Args>
+std::pair<V*, bool> FlatMap<K, V, Compare, Search>::TryEmplace(Key&& key_, Args&&... args_)
+{
+    const size_t index = LowerBoundIndex(key_);
+    if (index != keys.Size() && !comp(key_, keys[index]))
+    {
+        return { &values[index], false };
+    }
+    keys.Emplace(keys.begin() + index, std::forward<Key>(key_));
+    try
+    {
+        values.Emplace(values.begin() + index, std::forward<Args>(args_)...);
+    }
+    catch (...)
+    {
+        keys.Erase(keys.begin() + index);
+        throw;
+    }
+    RebuildSearch();
+    return { &values[index], true };
+}
+
+template <typename K, typename V, typename Compare, typename Search>
+template <typename Key, typename Value>
+std::pair<V*, bool> FlatMap<K, V, Compare, Search>::InsertOrAssign(Key&& key_, Value&& value_)
+{
+    const size_t index = IndexOf(key_);
+    if (index != keys.Size())
+    {
+        values[index] = std::forward<Value>(value_);
+        return { &values[index], false };
+    }
+    return TryEmplace(std::forward<Key>(key_), std::forward<Value>(value_));
+}
+
+template <typename K, typename V, typename Compare, typename Search>
+template <typename InputIt>
+size_t FlatMap<K, V, Compare, Search>::InsertBatch(InputIt first_, InputIt last_)
+{
+    const size_t old_size = keys.Size();
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        Reserve(old_size + std::distance(first_, last_));
+    }
+    try
+    {
+        for (; first_ != last_; ++first_)
+        {
+            // Moves out of the entry only when *first_ is an rvalue (e.g. through a move_iterator)
+            auto&& entry = *first_;
+            keys.EmplaceBack(std::get<0>(std::forward<decltype(entry)>(entry)));
+            values.EmplaceBack(std::get<1>(std::forward<decltype(entry)>(entry)));
+        }
+    }
+    catch (...)
+    {
+        keys.Erase(keys.begin() + old_size, keys.end());
+        values.Erase(values.begin() + old_size, values.end());
+        throw;
+    }
+    return MergeTail(old_size);
+}
+
+template <typename K, typename V, typename Compare, typename Search>
+template <std::ranges::input_range Range>
+size_t FlatMap<K, V, Compare, Search>::InsertBatch(Range&& range_)
+{
+    return InsertBatch(std::ranges::begin(range_), std::ranges::end(range_));
+}
+
+// The batch sits unsorted behind old_size_. It is ordered through an index permutation (the two columns cannot be
+// sorted together), moved out into scratch columns while dropping keys that repeat or already exist, and then merged
+// backwards into the columns, so every old element moves at most once
+template <typename K, typename V, typename Compare, typename Search>
+size_t FlatMap<K, V, Compare, Search>::MergeTail(size_t old_size_)
+{
+    const size_t batch_size = keys.Size() - old_size_;
+    if (batch_size == 0)
+    {
+        return 0;
+    }
+
+    Vector<size_t> order;
+    order.Reserve(batch_size);
+    for (size_t i = old_size_; i < keys.Size(); ++i)
+    {
+        order.PushBackUnchecked(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t lhs_, size_t rhs_)
+    {
+        return comp(keys[lhs_], keys[rhs_]);
+    });
+
+    Vector<K> new_keys;
+    Vector<V> new_values;
+    new_keys.Reserve(batch_size);
+    new_values.Reserve(batch_size);
+    for (size_t index : order)
+    {
+        const bool repeated = !new_keys.IsEmpty() && !comp(new_keys.Back(), keys[index]);
+        // The search index still describes the old prefix, which has not changed
+        const size_t existing = search.LowerBound(keys.Data(), old_size_, keys[index], comp);
+        if (!repeated && (existing == old_size_ || comp(keys[index], keys[existing])))
+        {
+            new_keys.PushBackUnchecked(std::move(keys[index]));
+            new_values.PushBackUnchecked(std::move(values[index]));
+        }
+    }
+
+    // The tail slots now only hold moved-from elements; keep as many as the merge needs
+    const size_t added = new_keys.Size();
+    keys.Erase(keys.begin() + old_size_ + added, keys.end());
+    values.Erase(values.begin() + old_size_ + added, values.end());
+
+    size_t old_left = old_size_;
+    size_t new_left = added;
+    for (size_t out = old_size_ + added; new_left > 0; )
+    {
+        --out;
+        if (old_left > 0 && comp(new_keys[new_left - 1], keys[old_left - 1]))
+        {
+            --old_left;
+            keys[out] = std::move(keys[old_left]);
+            values[out] = std::move(values[old_left]);
+        }
+        else
+        {
+            --new_left;
+            keys[out] = std::move(new_keys[new_left]);
+            values[out] = std::move(new_values[new_left]);
+        }
+    }
+
+    RebuildSearch();
+    return added;
+}
+
+template <typename K, typename V, typename Compare, typename Search>
+template <typename Predicate>
+size_t FlatMap<K, V, Compare, Search>::EraseIf(Predicate pred_)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < keys.Size(); ++i)
+    {
+        if (!pred_(std::as_const(keys[i]), std::as_const(values[i])))
+        {
+            if (kept != i)
+            {
+                keys[kept] = std::move(keys[i]);
+                values[kept] = std::move(values[i]);
+            }
+            ++kept;
+        }
+    }
+    const size_t erased = keys.Size() - kept;
+    if (erased != 0)
+    {
+        keys.Erase(keys.begin() + kept, keys.end());
+        values.Erase(values.begin() + kept, values.end());
+        RebuildSearch();
+    }
+    return erased;
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename K, typename V, typename Compare, typename Search>
+inline bool operator==(const FlatMap<K, V, Compare, Search>& lhs_, const FlatMap<K, V, Compare, Search>& rhs_)
+{
+    return lhs_.Keys() == rhs_.Keys() && std::ranges::equal(lhs_.Values(), rhs_.Values());
+}
+template <typename K, typename V, typename Compare, typename Search>
+inline bool operator!=(const FlatMap<K, V, Compare, Search>& lhs_, const FlatMap<K, V, Compare, Search>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
@@ -0,0 +1,420 @@
+#pragma once
+#include "custom_vector.h"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <ranges>
+
+//--------------------------------------------------------------------Search Policies-------------------------------------------------------
+// A search policy finds the lower bound of a key in the sorted key column. Rebuild is called after every modification
+// with the new column, so policies may keep an auxiliary layout; LowerBound only reads and is safe to call concurrently
+
+// Binary search whose loop body compiles to a conditional move instead of a hard-to-predict branch
+struct BranchlessSearch
+{
+    template <typename K>
+    void Rebuild(const K* /*keys_*/, size_t /*size_*/) noexcept {}
+
+    template <typename K, typename Compare>
+    size_t LowerBound(const K* keys_, size_t size_, const K& key_, const Compare& comp_) const noexcept
+    {
+        if (size_ == 0)
+        {
+            return 0;
+        }
+        const K* base = keys_;
+        for (size_t n = size_; n > 1; )
+        {
+            const size_t half = n / 2;
+            base = comp_(base[half], key_) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_t>(base - keys_) + static_cast<size_t>(comp_(*base, key_));
+    }
+};
+
+// Keeps a copy of the keys in Eytzinger (BFS) order, so every step of a search touches the next cache lines of one
+// predictable path and they can be prefetched. Costs a second copy of the keys plus an index per key, and an O(n)
+// rebuild per modification; pays off on large sets that are searched far more often than changed
+template <typename K>
+class EytzingerSearch
+{
+public:
+
+    void Rebuild(const K* keys_, size_t size_)
+    {
+        layout.Clear();
+        ranks.Clear();
+        if (size_ == 0)
+        {
+            return;
+        }
+        // Slot 0 is unused, so the children of slot k are 2k and 2k + 1. The slots are filled with placeholders
+        // first, so K needs no default constructor
+        layout.Reserve(size_ + 1);
+        for (size_t i = 0; i <= size_; ++i)
+        {
+            layout.EmplaceBackUnchecked(keys_[0]);
+        }
+        ranks.Resize(size_ + 1);
+        size_t rank = 0;
+        Fill(keys_, size_, 1, rank);
+    }
+
+    template <typename Compare>
+    size_t LowerBound(const K* /*keys_*/, size_t size_, const K& key_, const Compare& comp_) const noexcept
+    {
+        if (size_ == 0)
+        {
+            return 0;
+        }
+        const K* tree = layout.Data();
+        size_t k = 1;
+        while (k <= size_)
+        {
+            __builtin_prefetch(tree + std::min(k * PrefetchFanout, size_));
+            k = 2 * k + static_cast<size_t>(comp_(tree[k], key_));
+        }
+        // Undo the right turns taken after the last left turn; 0 means every key is less than key_
+        k >>= std::countr_one(k) + 1;
+        return k == 0 ? size_ : ranks[k];
+    }
+
+private:
+
+    // Descendants four levels down share a cache line for small keys
+    static constexpr size_t PrefetchFanout = 16;
+
+    Vector<K> layout;
+    Vector<size_t> ranks;
+
+    void Fill(const K* keys_, size_t size_, size_t k_, size_t& rank_)
+    {
+        if (k_ <= size_)
+        {
+            Fill(keys_, size_, 2 * k_, rank_);
+            layout[k_] = keys_[rank_];
+            ranks[k_] = rank_++;
+            Fill(keys_, size_, 2 * k_ + 1, rank_);
+        }
+    }
+};
+
+// Sorted set of unique keys in one contiguous Vector. Single inserts and erases shift the tail like any sorted array;
+// InsertBatch appends a whole range, sorts just the new tail and merges it in once, so k inserts into n keys cost
+// O(n + k log k) instead of O(k * n). All iterators are invalidated by every modification
+template <typename K, typename Compare = std::less<K>, typename Search = BranchlessSearch>
+class FlatSet
+{
+public:
+
+    using KeyType = K;
+    using ValueType = K;
+    using KeyCompare = Compare;
+    using SearchPolicy = Search;
+    using ConstIterator = const K*;
+    using Iterator = ConstIterator;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp_) : comp(comp_) {}
+
+    FlatSet(std::initializer_list<K> init_list_, const Compare& comp_ = Compare()) : comp(comp_)
+    {
+        InsertBatch(init_list_.begin(), init_list_.end());
+    }
+
+    // Takes over keys_ in any order; they are sorted and deduplicated
+    explicit FlatSet(Vector<K>&& keys_, const Compare& comp_ = Compare()) : keys(std::move(keys_)), comp(comp_)
+    {
+        std::sort(keys.begin(), keys.end(), comp);
+        Deduplicate(0);
+        RebuildSearch();
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    ConstIterator begin() const noexcept
+    {
+        return keys.begin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return keys.end();
+    }
+    ConstIterator cbegin() const noexcept
+    {
+        return keys.cbegin();
+    }
+    ConstIterator cend() const noexcept
+    {
+        return keys.cend();
+    }
+    ConstReverseIterator rbegin() const noexcept
+    {
+        return ConstReverseIterator(end());
+    }
+    ConstReverseIterator rend() const noexcept
+    {
+        return ConstReverseIterator(begin());
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return keys.Size();
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return keys.Capacity();
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return keys.IsEmpty();
+    }
+
+    const K* Data() const noexcept
+    {
+        return keys.Data();
+    }
+
+    // The sorted keys
+    const Vector<K>& Keys() const noexcept
+    {
+        return keys;
+    }
+
+    const Compare& KeyComp() const noexcept
+    {
+        return comp;
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        keys.Reserve(new_capacity_);
+    }
+
+    void ShrinkToFit()
+    {
+        keys.ShrinkToFit();
+    }
+
+    void Clear() noexcept
+    {
+        keys.Clear();
+        RebuildSearch();
+    }
+
+    // Moves the sorted keys out, leaving the set empty
+    Vector<K> Extract() &&
+    {
+        Vector<K> extracted = std::move(keys);
+        RebuildSearch();
+        return extracted;
+    }
+
+    ConstIterator LowerBound(const K& key_) const noexcept
+    {
+        return begin() + search.LowerBound(keys.Data(), keys.Size(), key_, comp);
+    }
+
+    ConstIterator UpperBound(const K& key_) const
+    {
+        return std::upper_bound(begin(), end(), key_, comp);
+    }
+
+    ConstIterator Find(const K& key_) const noexcept
+    {
+        const ConstIterator it = LowerBound(key_);
+        return it != end() && !comp(key_, *it) ? it : end();
+    }
+
+    bool Contains(const K& key_) const noexcept
+    {
+        return Find(key_) != end();
+    }
+
+    size_t Count(const K& key_) const noexcept
+    {
+        return Contains(key_) ? 1 : 0;
+    }
+
+    std::pair<ConstIterator, bool> Insert(const K& key_)
+    {
+        return Emplace(key_);
+    }
+
+    std::pair<ConstIterator, bool> Insert(K&& key_)
+    {
+        return Emplace(std::move(key_));
+    }
+
+    size_t Erase(const K& key_)
+    {
+        const ConstIterator it = Find(key_);
+        if (it == end())
+        {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    ConstIterator Erase(ConstIterator pos_)
+    {
+        return Erase(pos_, pos_ + 1);
+    }
+
+    ConstIterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        const size_t position = first_ - begin();
+        keys.Erase(first_, last_);
+        RebuildSearch();
+        return begin() + position;
+    }
+
+    void Swap(FlatSet& other_) noexcept(std::is_nothrow_swappable_v<Compare> && std::is_nothrow_swappable_v<Search>)
+    {
+        keys.Swap(other_.keys);
+        std::swap(comp, other_.comp);
+        std::swap(search, other_.search);
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    std::pair<ConstIterator, bool> Emplace(Args&&... args_);
+
+    // Inserts every key of the range that is not present yet (the first of equivalent keys in the range wins).
+    // Returns the number of keys added
+    template <typename InputIt>
+    size_t InsertBatch(InputIt first_, InputIt last_);
+
+    template <std::ranges::input_range Range>
+    size_t InsertBatch(Range&& range_);
+
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred_);
+
+private:
+
+    Vector<K> keys;
+    [[no_unique_address]] Compare comp;
+    [[no_unique_address]] Search search;
+
+    void RebuildSearch()
+    {
+        search.Rebuild(keys.Data(), keys.Size());
+    }
+
+    // Drops the later of adjacent equivalent keys in [from_, Size())
+    void Deduplicate(size_t from_)
+    {
+        auto new_end = std::unique(keys.begin() + from_, keys.end(), [this](const K& lhs_, const K& rhs_)
+        {
+            return !comp(lhs_, rhs_);
+        });
+        keys.Erase(new_end, keys.end());
+    }
+
+    // Sorts the keys appended after old_size_ and merges them into the sorted prefix
+    size_t MergeTail(size_t old_size_)
+    {
+        if (keys.Size() == old_size_)
+        {
+            return 0;
+        }
+        // Stable, so the first of equivalent keys in the batch stays in front
+        std::stable_sort(keys.begin() + old_size_, keys.end(), comp);
+        Deduplicate(old_size_);
+        // inplace_merge is stable as well: on ties the old key comes first, so deduplicating again keeps it
+        std::inplace_merge(keys.begin(), keys.begin() + old_size_, keys.end(), comp);
+        Deduplicate(0);
+
+        RebuildSearch();
+        return keys.Size() - old_size_;
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename K, typename Compare, typename Search>
+template <typename... Args>
+std::pair<typename FlatSet<K, Compare, Search>::ConstIterator, bool> FlatSet<K, Compare, Search>::Emplace(Args&&... args_)
+{
+    K key(std::forward<Args>(args_)...);
+    const ConstIterator it = LowerBound(key);
+    if (it != end() && !comp(key, *it))
+    {
+        return { it, false };
+    }
+    const ConstIterator inserted = keys.Emplace(it, std::move(key));
+    RebuildSearch();
+    return { inserted, true };
+}
+
+template <typename K, typename Compare, typename Search>
+template <typename InputIt>
+size_t FlatSet<K, Compare, Search>::InsertBatch(InputIt first_, InputIt last_)
+{
+    const size_t old_size = keys.Size();
+    try
+    {
+        keys.AppendRange(first_, last_);
+    }
+    catch (...)
+    {
+        keys.Erase(keys.begin() + old_size, keys.end());
+        throw;
+    }
+    return MergeTail(old_size);
+}
+
+template <typename K, typename Compare, typename Search>
+template <std::ranges::input_range Range>
+size_t FlatSet<K, Compare, Search>::InsertBatch(Range&& range_)
+{
+    const size_t old_size = keys.Size();
+    try
+    {
+        keys.AppendRange(std::forward<Range>(range_));
+    }
+    catch (...)
+    {
+        keys.Erase(keys.begin() + old_size, keys.end());
+        throw;
+    }
+    return MergeTail(old_size);
+}
+
+template <typename K, typename Compare, typename Search>
+template <typename Predicate>
+size_t FlatSet<K, Compare, Search>::EraseIf(Predicate pred_)
+{
+    const size_t old_size = keys.Size();
+    keys.EraseIf(pred_);
+    if (keys.Size() != old_size)
+    {
+        RebuildSearch();
+    }
+    return old_size - keys.Size();
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename K, typename Compare, typename Search>
+inline bool operator==(const FlatSet<K, Compare, Search>& lhs_, const FlatSet<K, Compare, Search>& rhs_)
+{
+    return lhs_.Keys() == rhs_.Keys();
+}
+template <typename K, typename Compare, typename Search>
+inline bool operator!=(const FlatSet<K, Compare, Search>& lhs_, const FlatSet<K, Compare, Search>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
@@ -1,9 +1,73 @@
 #include "custom_vector.h"
+#include "flat_map.h"
+#include "vector_io.h"
+#include <cassert>
+#include <chrono>
+#include <csignal>
 #include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <unistd.h>
 
 using namespace std;
 
+// InsertBatch from an lvalue source copies the entries and leaves the source intact
+static void TestFlatMapInsertBatchCopiesLvalues()
+{
+    vector<pair<string, string>> source = { { "b", "two" }, { "a", "one" } };
+
+    FlatMap<string, string> from_iterators;
+    from_iterators.InsertBatch(source.begin(), source.end());
+    FlatMap<string, string> from_range;
+    from_range.InsertBatch(source);
+
+    assert(source[0].first == "b" && source[0].second == "two");
+    assert(source[1].first == "a" && source[1].second == "one");
+    assert(from_iterators.Size() == 2 && from_iterators.At("a") == "one" && from_iterators.At("b") == "two");
+    assert(from_range.Size() == 2 && from_range.At("a") == "one" && from_range.At("b") == "two");
+
+    FlatMap<string, string> moved;
+    moved.InsertBatch(make_move_iterator(source.begin()), make_move_iterator(source.end()));
+    assert(moved.Size() == 2 && moved.At("b") == "two");
+}
+
+// A read interrupted by a signal (no SA_RESTART) before any data arrives is retried instead of reported as end of file
+static void TestAppendFromFdRetriesInterruptedRead()
+{
+    struct sigaction action = {};
+    action.sa_handler = [](int) {};
+    sigemptyset(&action.sa_mask);
+    struct sigaction previous;
+    sigaction(SIGUSR1, &action, &previous);
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    const pthread_t reader = pthread_self();
+    thread writer([&]()
+    {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        pthread_kill(reader, SIGUSR1);
+        this_thread::sleep_for(chrono::milliseconds(50));
+        const int values[3] = { 1, 2, 3 };
+        assert(write(fds[1], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)));
+        close(fds[1]);
+    });
+
+    Vector<int> received;
+    const size_t total = vector_io::AppendAllFromFd(fds[0], received);
+    writer.join();
+    close(fds[0]);
+    sigaction(SIGUSR1, &previous, nullptr);
+
+    assert(total == 3 && received.Size() == 3 && received[0] == 1 && received[2] == 3);
+}
+
 int main()
 {
-    
-}
\ No newline at end of file
+    TestFlatMapInsertBatchCopiesLvalues();
+    TestAppendFromFdRetriesInterruptedRead();
+}
@@ -0,0 +1,618 @@
+#pragma once
+#include "custom_vector.h"
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class MappedMode
+{
+    ReadOnly,
+    ReadWrite   // the file is created when it does not exist
+};
+
+// Identifies the element type stored in a mapped file. The default only encodes size and alignment; specialize it with
+// a stable value (e.g. a hash of the schema) for record types whose layout may change between releases
+template <typename T>
+struct MappedTypeTag : std::integral_constant<uint64_t, (uint64_t(sizeof(T)) << 32) | uint64_t(alignof(T))> {};
+
+// Lives at the start of the file; the elements follow at MappedVector::DataOffset
+struct MappedVectorHeader
+{
+    static constexpr uint64_t Magic = 0x524f544345564d41ull; // "AMVECTOR" in little-endian byte order
+    static constexpr uint32_t CurrentVersion = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t type_tag;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+// Vector whose storage is a shared mapping of a file. Size and capacity live in the mapped header, so the file is
+// always up to date in the page cache; opening an existing file maps it without reading it, and pages come in lazily
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector
+{
+public:
+
+    static constexpr size_t DataOffset = 64;
+
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores the raw bytes of its elements");
+    static_assert(alignof(T) <= DataOffset, "the element block starts DataOffset bytes into a page-aligned mapping");
+    static_assert(sizeof(MappedVectorHeader) <= DataOffset);
+
+    using GrowthPolicy = Growth;
+    using ValueType = T;
+    using Iterator = T*;
+    using ConstIterator = const T*;
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    explicit MappedVector(const std::string& path_, MappedMode mode_ = MappedMode::ReadWrite) : mode(mode_)
+    {
+        const bool writable = mode_ == MappedMode::ReadWrite;
+        fd = ::open(path_.c_str(), writable ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: cannot open " + path_);
+        }
+        try
+        {
+            struct stat info {};
+            if (::fstat(fd, &info) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "MappedVector: fstat");
+            }
+            if (info.st_size == 0 && writable)
+            {
+                Truncate(DataOffset);
+                Map(DataOffset);
+                *Header() = MappedVectorHeader{ MappedVectorHeader::Magic, MappedVectorHeader::CurrentVersion, sizeof(T), MappedTypeTag<T>::value, 0, 0 };
+            }
+            else if (static_cast<size_t>(info.st_size) < DataOffset)
+            {
+                throw std::runtime_error("MappedVector: file is too small to hold a header");
+            }
+            else
+            {
+                Map(static_cast<size_t>(info.st_size));
+                Validate();
+            }
+        }
+        catch (...)
+        {
+            Close();
+            throw;
+        }
+    }
+
+    MappedVector(MappedVector&& other_) noexcept
+        : fd(std::exchange(other_.fd, -1))
+        , mode(other_.mode)
+        , mapping(std::exchange(other_.mapping, nullptr))
+        , mapped_bytes(std::exchange(other_.mapped_bytes, 0)) {}
+
+    MappedVector(const MappedVector&) = delete;
+
+    ~MappedVector()
+    {
+        Close();
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    MappedVector& operator=(MappedVector&& rhs_) noexcept
+    {
+        if (this != &rhs_)
+        {
+            Close();
+            fd = std::exchange(rhs_.fd, -1);
+            mode = rhs_.mode;
+            mapping = std::exchange(rhs_.mapping, nullptr);
+            mapped_bytes = std::exchange(rhs_.mapped_bytes, 0);
+        }
+        return *this;
+    }
+
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        return const_cast<MappedVector&>(*this)[index_];
+    }
+
+    T& operator[](size_t index_) noexcept
+    {
+        assert(index_ < Size());
+        return Elements()[index_];
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Elements();
+    }
+    Iterator end() noexcept
+    {
+        return Elements() + Size();
+    }
+
+    ConstIterator cbegin() const noexcept
+    {
+        return Elements();
+    }
+    ConstIterator cend() const noexcept
+    {
+        return Elements() + Size();
+    }
+
+    ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+
+    ReverseIterator rbegin() noexcept
+    {
+        return ReverseIterator(end());
+    }
+    ReverseIterator rend() noexcept
+    {
+        return ReverseIterator(begin());
+    }
+
+    ConstReverseIterator crbegin() const noexcept
+    {
+        return ConstReverseIterator(cend());
+    }
+    ConstReverseIterator crend() const noexcept
+    {
+        return ConstReverseIterator(cbegin());
+    }
+
+    ConstReverseIterator rbegin() const noexcept
+    {
+        return crbegin();
+    }
+    ConstReverseIterator rend() const noexcept
+    {
+        return crend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return static_cast<size_t>(Header()->size);
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return static_cast<size_t>(Header()->capacity);
+    }
+
+    size_t MaxSize() const noexcept
+    {
+        return (std::numeric_limits<size_t>::max() - DataOffset) / sizeof(T);
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    bool IsWritable() const noexcept
+    {
+        return mode == MappedMode::ReadWrite;
+    }
+
+    void Clear() noexcept
+    {
+        assert(IsWritable());
+        Header()->size = 0;
+    }
+
+    T& Front() noexcept
+    {
+        assert(Size());
+        return Elements()[0];
+    }
+    const T& Front() const noexcept
+    {
+        assert(Size());
+        return Elements()[0];
+    }
+
+    T& Back() noexcept
+    {
+        assert(Size());
+        return Elements()[Size() - 1];
+    }
+    const T& Back() const noexcept
+    {
+        assert(Size());
+        return Elements()[Size() - 1];
+    }
+
+    Iterator Data() noexcept
+    {
+        return Elements();
+    }
+    ConstIterator Data() const noexcept
+    {
+        return Elements();
+    }
+
+    T& At(size_t index_)
+    {
+        if (index_ >= Size())
+        {
+            throw std::out_of_range("MappedVector::At");
+        }
+        return Elements()[index_];
+    }
+    const T& At(size_t index_) const
+    {
+        return const_cast<MappedVector&>(*this).At(index_);
+    }
+
+    void Swap(MappedVector& other_) noexcept
+    {
+        std::swap(fd, other_.fd);
+        std::swap(mode, other_.mode);
+        std::swap(mapping, other_.mapping);
+        std::swap(mapped_bytes, other_.mapped_bytes);
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        if (new_capacity_ > Capacity())
+        {
+            Remap(new_capacity_);
+        }
+    }
+
+    // New elements are value-initialized as all-zero bytes
+    void Resize(size_t new_size_)
+    {
+        assert(IsWritable());
+        Reserve(new_size_);
+        if (new_size_ > Size())
+        {
+            std::memset(static_cast<void*>(Elements() + Size()), 0, (new_size_ - Size()) * sizeof(T));
+        }
+        Header()->size = new_size_;
+    }
+
+    // New elements keep whatever bytes the file holds there, without touching the pages
+    void ResizeForOverwrite(size_t new_size_)
+    {
+        assert(IsWritable());
+        Reserve(new_size_);
+        Header()->size = new_size_;
+    }
+
+    // Shrinks the file as well as the mapping
+    void ShrinkToFit()
+    {
+        if (Size() != Capacity())
+        {
+            Remap(Size());
+        }
+    }
+
+    // Flushes dirty pages to the file; without it the kernel writes them back on its own schedule
+    void Sync()
+    {
+        if (::msync(mapping, mapped_bytes, MS_SYNC) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: msync");
+        }
+    }
+
+    void PushBack(const T& value_)
+    {
+        EmplaceBack(value_);
+    }
+
+    Iterator Insert(ConstIterator pos_, const T& item_)
+    {
+        return Emplace(pos_, item_);
+    }
+
+    Iterator Erase(ConstIterator pos_)
+    {
+        return Erase(pos_, pos_ + 1);
+    }
+
+    Iterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        assert(IsWritable());
+        assert(first_ >= begin() && first_ <= last_ && last_ <= end());
+        const size_t position = first_ - begin();
+        const size_t count = last_ - first_;
+
+        std::memmove(static_cast<void*>(Elements() + position), static_cast<const void*>(Elements() + position + count), (Size() - position - count) * sizeof(T));
+        Header()->size -= count;
+
+        return begin() + position;
+    }
+
+    void PopBack()
+    {
+        assert(IsWritable());
+        assert(Size());
+        Header()->size -= 1;
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args_);
+
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos_, Args&&... args_);
+
+    template <typename InputIt>
+    void Assign(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    void AppendRange(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    Iterator InsertRange(ConstIterator pos_, InputIt first_, InputIt last_);
+
+    template <typename Predicate>
+    void EraseIf(Predicate pred_);
+
+private:
+
+    int fd = -1;
+    MappedMode mode = MappedMode::ReadWrite;
+    unsigned char* mapping = nullptr;
+    size_t mapped_bytes = 0;
+
+    MappedVectorHeader* Header() const noexcept
+    {
+        return reinterpret_cast<MappedVectorHeader*>(mapping);
+    }
+
+    T* Elements() const noexcept
+    {
+        return reinterpret_cast<T*>(mapping + DataOffset);
+    }
+
+    static size_t BytesFor(size_t capacity_) noexcept
+    {
+        return DataOffset + capacity_ * sizeof(T);
+    }
+
+    size_t GrownCapacity(size_t required_) const noexcept
+    {
+        return std::min(std::max(Growth::NextCapacity(Capacity(), required_, sizeof(T)), required_), MaxSize());
+    }
+
+    void Truncate(size_t bytes_)
+    {
+        if (::ftruncate(fd, static_cast<off_t>(bytes_)) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: ftruncate");
+        }
+    }
+
+    void Map(size_t bytes_)
+    {
+        const int protection = IsWritable() ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* address = ::mmap(nullptr, bytes_, protection, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: mmap");
+        }
+        mapping = static_cast<unsigned char*>(address);
+        mapped_bytes = bytes_;
+    }
+
+    // Resizes the file and the mapping to hold exactly new_capacity_ elements
+    void Remap(size_t new_capacity_)
+    {
+        assert(IsWritable());
+        assert(new_capacity_ >= Size());
+        if (new_capacity_ > MaxSize())
+        {
+            throw std::length_error("MappedVector: capacity exceeds MaxSize()");
+        }
+        const size_t new_bytes = BytesFor(new_capacity_);
+        if (new_bytes > mapped_bytes)
+        {
+            Truncate(new_bytes);
+        }
+#if defined(__linux__)
+        void* address = ::mremap(mapping, mapped_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (address == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "MappedVector: mremap");
+        }
+        mapping = static_cast<unsigned char*>(address);
+        mapped_bytes = new_bytes;
+#else
+        ::munmap(mapping, mapped_bytes);
+        mapping = nullptr;
+        Map(new_bytes);
+#endif
+        if (new_bytes < BytesFor(Capacity()))
+        {
+            Truncate(new_bytes);
+        }
+        Header()->capacity = new_capacity_;
+    }
+
+    void Validate() const
+    {
+        const MappedVectorHeader& header = *Header();
+        if (header.magic != MappedVectorHeader::Magic || header.version != MappedVectorHeader::CurrentVersion)
+        {
+            throw std::runtime_error("MappedVector: not a MappedVector file or unsupported version");
+        }
+        if (header.element_size != sizeof(T) || header.type_tag != MappedTypeTag<T>::value)
+        {
+            throw std::runtime_error("MappedVector: file holds a different element type");
+        }
+        if (header.size > header.capacity || header.capacity > (mapped_bytes - DataOffset) / sizeof(T))
+        {
+            throw std::runtime_error("MappedVector: header does not match the file size");
+        }
+    }
+
+    void Close() noexcept
+    {
+        if (mapping != nullptr)
+        {
+            ::munmap(mapping, mapped_bytes);
+            mapping = nullptr;
+            mapped_bytes = 0;
+        }
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename T, typename Growth>
+template <typename... Args>
+T& MappedVector<T, Growth>::EmplaceBack(Args&&... args_)
+{
+    return *Emplace(cend(), std::forward<Args>(args_)...);
+}
+
+template <typename T, typename Growth>
+template <typename... Args>
+MappedVector<T, Growth>::Iterator MappedVector<T, Growth>::Emplace(ConstIterator pos_, Args&&... args_)
+{
+    assert(IsWritable());
+    assert(pos_ >= begin() && pos_ <= end());
+    const size_t position = pos_ - begin();
+
+    // Built before any remap, since the arguments may refer into the mapping
+    T value(std::forward<Args>(args_)...);
+    if (Size() == Capacity())
+    {
+        Remap(GrownCapacity(Size() + 1));
+    }
+    T* gap = Elements() + position;
+    std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), (Size() - position) * sizeof(T));
+    std::memcpy(static_cast<void*>(gap), static_cast<const void*>(&value), sizeof(T));
+    Header()->size += 1;
+
+    return gap;
+}
+
+template <typename T, typename Growth>
+template <typename InputIt>
+void MappedVector<T, Growth>::Assign(InputIt first_, InputIt last_)
+{
+    Clear();
+    AppendRange(first_, last_);
+}
+
+template <typename T, typename Growth>
+template <typename InputIt>
+void MappedVector<T, Growth>::AppendRange(InputIt first_, InputIt last_)
+{
+    InsertRange(cend(), first_, last_);
+}
+
+template <typename T, typename Growth>
+template <typename InputIt>
+MappedVector<T, Growth>::Iterator MappedVector<T, Growth>::InsertRange(ConstIterator pos_, InputIt first_, InputIt last_)
+{
+    assert(IsWritable());
+    assert(pos_ >= begin() && pos_ <= end());
+    const size_t position = pos_ - begin();
+
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        const size_t count = std::distance(first_, last_);
+        if (Size() + count > Capacity())
+        {
+            Remap(GrownCapacity(Size() + count));
+        }
+        T* gap = Elements() + position;
+        std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), (Size() - position) * sizeof(T));
+        std::copy(first_, last_, gap);
+        Header()->size += count;
+    }
+    else
+    {
+        const size_t old_size = Size();
+        for (; first_ != last_; ++first_)
+        {
+            EmplaceBack(*first_);
+        }
+        std::rotate(begin() + position, begin() + old_size, end());
+    }
+    return begin() + position;
+}
+
+template <typename T, typename Growth>
+template <typename Predicate>
+void MappedVector<T, Growth>::EraseIf(Predicate pred_)
+{
+    assert(IsWritable());
+    Header()->size = std::remove_if(begin(), end(), pred_) - begin();
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename T, typename Growth>
+inline bool operator==(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return vector_detail::RangesEqual(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
+template <typename T, typename Growth>
+inline bool operator!=(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
+template <typename T, typename Growth>
+inline bool operator<(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return vector_detail::RangesLess(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
+template <typename T, typename Growth>
+inline bool operator<=(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return !(rhs_ < lhs_);
+}
+template <typename T, typename Growth>
+inline bool operator>(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return rhs_ < lhs_;
+}
+template <typename T, typename Growth>
+inline bool operator>=(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return !(lhs_ < rhs_);
+}
+template <typename T, typename Growth>
+constexpr auto operator<=>(const MappedVector<T, Growth>& lhs_, const MappedVector<T, Growth>& rhs_)
+{
+    return vector_detail::RangesThreeWay(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
@@ -0,0 +1,276 @@
+#pragma once
+#include "bit_vector.h"
+
+// Vector of Bits-wide unsigned integers stored back to back in 64-bit words (values may straddle two words), for ID
+// lists and codes whose range is far below uint32_t. The words live in a Vector<uint64_t, Alloc, Growth>, so growth and
+// Reserve follow Vector's rules. One spare word always follows the data, so any value can be read with a single
+// unaligned 8-byte load
+template <size_t Bits, typename Alloc = std::allocator<uint64_t>, typename Growth = DoublingGrowth>
+class PackedVector
+{
+public:
+
+    static_assert(Bits >= 1 && Bits <= 32, "PackedVector stores values of 1 to 32 bits");
+
+    using ValueType = uint32_t;
+    using WordVector = Vector<uint64_t, Alloc, Growth>;
+
+    static constexpr uint64_t ValueMask = (uint64_t(1) << Bits) - 1;
+    static constexpr ValueType MaxValue = static_cast<ValueType>(ValueMask);
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    PackedVector() = default;
+
+    explicit PackedVector(size_t size_)
+    {
+        Resize(size_);
+    }
+
+    PackedVector(std::initializer_list<ValueType> init_list_)
+    {
+        AppendRange(init_list_.begin(), init_list_.end());
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    ValueType operator[](size_t index_) const noexcept
+    {
+        assert(index_ < size);
+        return Load(index_);
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return words.Capacity() <= 1 ? 0 : (words.Capacity() - 1) * bit_detail::WordBits / Bits;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    // The packed words, including the spare one at the end
+    const WordVector& Words() const noexcept
+    {
+        return words;
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        words.Reserve(WordsFor(new_capacity_));
+    }
+
+    void ShrinkToFit()
+    {
+        words.ShrinkToFit();
+    }
+
+    size_t MemoryFootprint() const noexcept
+    {
+        return words.MemoryFootprint();
+    }
+
+    void Clear() noexcept
+    {
+        words.Clear();
+        size = 0;
+    }
+
+    ValueType Get(size_t index_) const noexcept
+    {
+        return (*this)[index_];
+    }
+
+    // value_ must fit in Bits bits
+    void Set(size_t index_, ValueType value_) noexcept
+    {
+        assert(index_ < size);
+        Store(index_, value_);
+    }
+
+    void PushBack(ValueType value_)
+    {
+        EnsureWords(size + 1);
+        Store(size, value_);
+        ++size;
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size);
+        Store(size - 1, 0);
+        --size;
+    }
+
+    ValueType Back() const noexcept
+    {
+        return (*this)[size - 1];
+    }
+
+    // New values are zero
+    void Resize(size_t new_size_)
+    {
+        if (new_size_ < size)
+        {
+            for (size_t i = new_size_; i < size; ++i)
+            {
+                Store(i, 0);
+            }
+            words.Resize(new_size_ == 0 ? 0 : WordsFor(new_size_));
+        }
+        else
+        {
+            EnsureWords(new_size_);
+        }
+        size = new_size_;
+    }
+
+    // Decodes count_ values starting at first_ into dest_. With AVX2, four values are fetched per gather and shifted
+    // into place in parallel
+    void Unpack(size_t first_, size_t count_, ValueType* dest_) const noexcept
+    {
+        assert(first_ + count_ <= size);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(words.Data());
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(ValueMask));
+        const __m256i seven = _mm256_set1_epi64x(7);
+        const __m256i step = _mm256_set1_epi64x(4 * Bits);
+        const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        const long long base = static_cast<long long>(first_ * Bits);
+        __m256i positions = _mm256_setr_epi64x(base, base + Bits, base + 2 * Bits, base + 3 * Bits);
+        for (; i + 4 <= count_; i += 4)
+        {
+            const __m256i offsets = _mm256_srli_epi64(positions, 3);
+            const __m256i raw = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(bytes), offsets, 1);
+            const __m256i values = _mm256_and_si256(_mm256_srlv_epi64(raw, _mm256_and_si256(positions, seven)), mask);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest_ + i), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(values, pack)));
+            positions = _mm256_add_epi64(positions, step);
+        }
+#endif
+        for (; i < count_; ++i)
+        {
+            dest_[i] = LoadFrom(bytes, first_ + i);
+        }
+    }
+
+    // Replaces the contents of out_ with every value, decoded in bulk
+    template <typename OutAlloc, typename OutGrowth>
+    void Unpack(Vector<ValueType, OutAlloc, OutGrowth>& out_) const
+    {
+        out_.ResizeForOverwrite(size);
+        Unpack(0, size, out_.Data());
+    }
+
+    Vector<ValueType> Unpack() const
+    {
+        Vector<ValueType> out;
+        Unpack(out);
+        return out;
+    }
+
+    void Swap(PackedVector& other_) noexcept
+    {
+        words.Swap(other_.words);
+        std::swap(size, other_.size);
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename InputIt>
+    void AppendRange(InputIt first_, InputIt last_);
+
+private:
+
+    WordVector words;
+    size_t size = 0;
+
+    // Data words for count_ values plus the spare word
+    static constexpr size_t WordsFor(size_t count_) noexcept
+    {
+        return bit_detail::WordsFor(count_ * Bits) + 1;
+    }
+
+    void EnsureWords(size_t count_)
+    {
+        const size_t needed = WordsFor(count_);
+        if (needed > words.Size())
+        {
+            words.Resize(needed);
+        }
+    }
+
+    static ValueType LoadFrom(const unsigned char* bytes_, size_t index_) noexcept
+    {
+        const size_t position = index_ * Bits;
+        uint64_t raw;
+        std::memcpy(&raw, bytes_ + position / 8, sizeof(raw));
+        return static_cast<ValueType>((raw >> (position % 8)) & ValueMask);
+    }
+
+    ValueType Load(size_t index_) const noexcept
+    {
+        return LoadFrom(reinterpret_cast<const unsigned char*>(words.Data()), index_);
+    }
+
+    void Store(size_t index_, ValueType value_) noexcept
+    {
+        assert(value_ <= MaxValue);
+        const size_t position = index_ * Bits;
+        const size_t word = position / bit_detail::WordBits;
+        const size_t offset = position % bit_detail::WordBits;
+        words[word] = (words[word] & ~(ValueMask << offset)) | (uint64_t(value_) << offset);
+        if (offset + Bits > bit_detail::WordBits)
+        {
+            const size_t spill = bit_detail::WordBits - offset;
+            words[word + 1] = (words[word + 1] & ~(ValueMask >> spill)) | (uint64_t(value_) >> spill);
+        }
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <size_t Bits, typename Alloc, typename Growth>
+template <typename InputIt>
+void PackedVector<Bits, Alloc, Growth>::AppendRange(InputIt first_, InputIt last_)
+{
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        const size_t count = std::distance(first_, last_);
+        EnsureWords(size + count);
+        for (; first_ != last_; ++first_)
+        {
+            Store(size++, static_cast<ValueType>(*first_));
+        }
+    }
+    else
+    {
+        for (; first_ != last_; ++first_)
+        {
+            PushBack(static_cast<ValueType>(*first_));
+        }
+    }
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <size_t Bits, typename Alloc, typename Growth>
+inline bool operator==(const PackedVector<Bits, Alloc, Growth>& lhs_, const PackedVector<Bits, Alloc, Growth>& rhs_)
+{
+    // Unused bits are kept zero, so equal contents means equal data words (PopBack keeps the words, so compare only those in use)
+    const size_t used = lhs_.IsEmpty() ? 0 : bit_detail::WordsFor(lhs_.Size() * Bits);
+    return lhs_.Size() == rhs_.Size() && vector_detail::RangesEqual(lhs_.Words().Data(), used, rhs_.Words().Data(), used);
+}
+template <size_t Bits, typename Alloc, typename Growth>
+inline bool operator!=(const PackedVector<Bits, Alloc, Growth>& lhs_, const PackedVector<Bits, Alloc, Growth>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
@@ -0,0 +1,544 @@
+#pragma once
+#include "custom_vector.h"
+#include <bit>
+#include <compare>
+#include <stdexcept>
+
+namespace segmented_detail
+{
+    // About 16 KiB per chunk, rounded down to a power of two so that indexing is a shift and a mask
+    template <typename T>
+    constexpr size_t DefaultChunkSize() noexcept
+    {
+        return std::bit_floor(std::max<size_t>(16, (size_t(16) << 10) / sizeof(T)));
+    }
+}
+
+// Sequence of fixed-size RawMemory chunks. Elements never move once constructed, so references, pointers and iterators
+// stay valid across PushBack/EmplaceBack (iterators refer to the container, not to the chunk table); growth only adds a
+// chunk and never copies existing elements. Chunks emptied by PopBack/Clear are kept for reuse until ShrinkToFit
+template <typename T, size_t ChunkSize = segmented_detail::DefaultChunkSize<T>(), typename Alloc = std::allocator<T>>
+class SegmentedVector
+{
+public:
+
+    static_assert(std::has_single_bit(ChunkSize), "chunk size must be a power of two");
+
+    static constexpr size_t ChunkShift = std::countr_zero(ChunkSize);
+    static constexpr size_t ChunkMask = ChunkSize - 1;
+
+    using AllocatorType = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using ValueType = T;
+
+    template <bool IsConst>
+    class BasicIterator
+    {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(const SegmentedVector* owner_, size_t index_) noexcept : owner(owner_), index(index_) {}
+
+        // Iterator -> ConstIterator
+        template <bool OtherConst> requires (IsConst && !OtherConst)
+        BasicIterator(const BasicIterator<OtherConst>& other_) noexcept : owner(other_.owner), index(other_.index) {}
+
+        reference operator*() const noexcept
+        {
+            return const_cast<RawMemory<T, Alloc>&>(owner->chunks[index >> ChunkShift])[index & ChunkMask];
+        }
+        pointer operator->() const noexcept
+        {
+            return std::addressof(**this);
+        }
+        reference operator[](difference_type offset_) const noexcept
+        {
+            return *(*this + offset_);
+        }
+
+        BasicIterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+        BasicIterator operator++(int) noexcept
+        {
+            BasicIterator copy = *this;
+            ++index;
+            return copy;
+        }
+        BasicIterator& operator--() noexcept
+        {
+            --index;
+            return *this;
+        }
+        BasicIterator operator--(int) noexcept
+        {
+            BasicIterator copy = *this;
+            --index;
+            return copy;
+        }
+
+        BasicIterator& operator+=(difference_type offset_) noexcept
+        {
+            index += offset_;
+            return *this;
+        }
+        BasicIterator& operator-=(difference_type offset_) noexcept
+        {
+            index -= offset_;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it_, difference_type offset_) noexcept
+        {
+            return it_ += offset_;
+        }
+        friend BasicIterator operator+(difference_type offset_, BasicIterator it_) noexcept
+        {
+            return it_ += offset_;
+        }
+        friend BasicIterator operator-(BasicIterator it_, difference_type offset_) noexcept
+        {
+            return it_ -= offset_;
+        }
+        friend difference_type operator-(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return static_cast<difference_type>(lhs_.index) - static_cast<difference_type>(rhs_.index);
+        }
+
+        friend bool operator==(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index == rhs_.index;
+        }
+        friend auto operator<=>(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index <=> rhs_.index;
+        }
+
+    private:
+
+        template <bool>
+        friend class BasicIterator;
+
+        const SegmentedVector* owner = nullptr;
+        size_t index = 0;
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc_) noexcept : allocator(alloc_) {}
+
+    explicit SegmentedVector(size_t size_, const Alloc& alloc_ = Alloc()) : SegmentedVector(alloc_)
+    {
+        Resize(size_);
+    }
+
+    SegmentedVector(const SegmentedVector& other_) : SegmentedVector(AllocTraits::select_on_container_copy_construction(other_.allocator))
+    {
+        AppendFrom(other_);
+    }
+
+    SegmentedVector(SegmentedVector&& other_) noexcept
+        : allocator(other_.allocator)
+        , chunks(std::move(other_.chunks))
+        , size(std::exchange(other_.size, 0)) {}
+
+    SegmentedVector(std::initializer_list<T> init_list_, const Alloc& alloc_ = Alloc()) : SegmentedVector(alloc_)
+    {
+        Reserve(init_list_.size());
+        for (const T& item : init_list_)
+        {
+            EmplaceBack(item);
+        }
+    }
+
+    ~SegmentedVector()
+    {
+        Clear();
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    SegmentedVector& operator=(const SegmentedVector& rhs_)
+    {
+        if (this != &rhs_)
+        {
+            Clear();
+            AppendFrom(rhs_);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs_) noexcept(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+    {
+        if (this != &rhs_)
+        {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+            {
+                AdoptChunks(rhs_);
+            }
+            else if (allocator == rhs_.allocator)
+            {
+                AdoptChunks(rhs_);
+            }
+            else
+            {
+                // Unequal allocators that do not propagate: rhs_'s chunks cannot change hands, so move element-wise
+                // into chunks from this vector's own allocator
+                Clear();
+                Reserve(rhs_.size);
+                for (size_t i = 0; i < rhs_.size; ++i)
+                {
+                    EmplaceBack(std::move(rhs_[i]));
+                }
+            }
+        }
+        return *this;
+    }
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        return const_cast<SegmentedVector&>(*this)[index_];
+    }
+
+    T& operator[](size_t index_) noexcept
+    {
+        assert(index_ < size);
+        return chunks[index_ >> ChunkShift][index_ & ChunkMask];
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Iterator(this, 0);
+    }
+    Iterator end() noexcept
+    {
+        return Iterator(this, size);
+    }
+
+    ConstIterator cbegin() const noexcept
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator cend() const noexcept
+    {
+        return ConstIterator(this, size);
+    }
+
+    ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+
+    ReverseIterator rbegin() noexcept
+    {
+        return ReverseIterator(end());
+    }
+    ReverseIterator rend() noexcept
+    {
+        return ReverseIterator(begin());
+    }
+
+    ConstReverseIterator crbegin() const noexcept
+    {
+        return ConstReverseIterator(cend());
+    }
+    ConstReverseIterator crend() const noexcept
+    {
+        return ConstReverseIterator(cbegin());
+    }
+
+    ConstReverseIterator rbegin() const noexcept
+    {
+        return crbegin();
+    }
+    ConstReverseIterator rend() const noexcept
+    {
+        return crend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return chunks.Size() * ChunkSize;
+    }
+
+    size_t ChunkCount() const noexcept
+    {
+        return chunks.Size();
+    }
+
+    Alloc Allocator() const noexcept
+    {
+        return allocator;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    // Destroys the elements but keeps every chunk for reuse
+    void Clear() noexcept
+    {
+        for (size_t first = 0; first < size; first += ChunkSize)
+        {
+            vector_detail::DestroyN(chunks[first >> ChunkShift].GetAllocator(), chunks[first >> ChunkShift].GetAddress(), std::min(ChunkSize, size - first));
+        }
+        size = 0;
+    }
+
+    T& Front() noexcept
+    {
+        assert(size);
+        return (*this)[0];
+    }
+    const T& Front() const noexcept
+    {
+        assert(size);
+        return (*this)[0];
+    }
+
+    T& Back() noexcept
+    {
+        assert(size);
+        return (*this)[size - 1];
+    }
+    const T& Back() const noexcept
+    {
+        assert(size);
+        return (*this)[size - 1];
+    }
+
+    T& At(size_t index_)
+    {
+        if (index_ >= size)
+        {
+            throw std::out_of_range("SegmentedVector::At");
+        }
+        return (*this)[index_];
+    }
+    const T& At(size_t index_) const
+    {
+        return const_cast<SegmentedVector&>(*this).At(index_);
+    }
+
+    // Allocators that do not propagate on swap must compare equal, as for any allocator-aware container
+    void Swap(SegmentedVector& other_) noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_swap::value)
+        {
+            using std::swap;
+            swap(allocator, other_.allocator);
+        }
+        else
+        {
+            assert(allocator == other_.allocator);
+        }
+        chunks.Swap(other_.chunks);
+        std::swap(size, other_.size);
+    }
+
+    // Allocates chunks up front; nothing already stored moves
+    void Reserve(size_t new_capacity_)
+    {
+        const size_t needed = (new_capacity_ + ChunkSize - 1) >> ChunkShift;
+        if (needed > chunks.Size())
+        {
+            chunks.Reserve(needed);
+            while (chunks.Size() < needed)
+            {
+                chunks.EmplaceBack(ChunkSize, allocator);
+            }
+        }
+    }
+
+    void Resize(size_t new_size_)
+    {
+        if (new_size_ < size)
+        {
+            while (size > new_size_)
+            {
+                PopBack();
+            }
+        }
+        else
+        {
+            Reserve(new_size_);
+            while (size < new_size_)
+            {
+                EmplaceBack();
+            }
+        }
+    }
+
+    // Frees the chunks no element lives in
+    void ShrinkToFit()
+    {
+        const size_t used = (size + ChunkSize - 1) >> ChunkShift;
+        while (chunks.Size() > used)
+        {
+            chunks.PopBack();
+        }
+        chunks.ShrinkToFit();
+    }
+
+    void PopBack()
+    {
+        assert(size);
+        --size;
+        vector_detail::DestroyN(chunks[size >> ChunkShift].GetAllocator(), chunks[size >> ChunkShift].GetAddress() + (size & ChunkMask), 1);
+    }
+
+    template <typename Type>
+    void PushBack(Type&& value_)
+    {
+        EmplaceBack(std::forward<Type>(value_));
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args_);
+
+    template <typename InputIt>
+    void AppendRange(InputIt first_, InputIt last_);
+
+    template <typename Predicate>
+    void EraseIf(Predicate pred_);
+
+private:
+
+    [[no_unique_address]] Alloc allocator;
+    Vector<RawMemory<T, Alloc>> chunks;
+    size_t size = 0;
+
+    void AppendFrom(const SegmentedVector& other_)
+    {
+        Reserve(other_.size);
+        for (const T& item : other_)
+        {
+            EmplaceBack(item);
+        }
+    }
+
+    // Takes over other_'s chunks (and its allocator, when that propagates); only valid when they may change hands
+    void AdoptChunks(SegmentedVector& other_) noexcept
+    {
+        Clear();
+        chunks = std::move(other_.chunks);
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value)
+        {
+            allocator = std::move(other_.allocator);
+        }
+        size = std::exchange(other_.size, 0);
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename T, size_t ChunkSize, typename Alloc>
+template <typename... Args>
+T& SegmentedVector<T, ChunkSize, Alloc>::EmplaceBack(Args&&... args_)
+{
+    if (size == Capacity())
+    {
+        // The chunk table is the only thing that ever regrows, and it only holds chunk handles
+        chunks.EmplaceBack(ChunkSize, allocator);
+    }
+    RawMemory<T, Alloc>& chunk = chunks[size >> ChunkShift];
+    T* slot = chunk.GetAddress() + (size & ChunkMask);
+    vector_detail::Construct(chunk.GetAllocator(), slot, std::forward<Args>(args_)...);
+    ++size;
+    return *slot;
+}
+
+template <typename T, size_t ChunkSize, typename Alloc>
+template <typename InputIt>
+void SegmentedVector<T, ChunkSize, Alloc>::AppendRange(InputIt first_, InputIt last_)
+{
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        Reserve(size + std::distance(first_, last_));
+    }
+    for (; first_ != last_; ++first_)
+    {
+        EmplaceBack(*first_);
+    }
+}
+
+template <typename T, size_t ChunkSize, typename Alloc>
+template <typename Predicate>
+void SegmentedVector<T, ChunkSize, Alloc>::EraseIf(Predicate pred_)
+{
+    const size_t new_size = std::remove_if(begin(), end(), pred_) - begin();
+    while (size > new_size)
+    {
+        PopBack();
+    }
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator==(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return lhs_.Size() == rhs_.Size() && std::equal(lhs_.begin(), lhs_.end(), rhs_.begin());
+}
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator!=(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator<(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return std::lexicographical_compare(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+}
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator<=(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return !(rhs_ < lhs_);
+}
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator>(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return rhs_ < lhs_;
+}
+template <typename T, size_t ChunkSize, typename Alloc>
+inline bool operator>=(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return !(lhs_ < rhs_);
+}
+template <typename T, size_t ChunkSize, typename Alloc>
+constexpr auto operator<=>(const SegmentedVector<T, ChunkSize, Alloc>& lhs_, const SegmentedVector<T, ChunkSize, Alloc>& rhs_)
+{
+    return std::lexicographical_compare_three_way(lhs_.begin(), lhs_.end(), rhs_.begin(), rhs_.end());
+}
@@ -0,0 +1,663 @@
+#pragma once
+#include "custom_vector.h"
+
+// Vector with room for N elements inside the object itself; the heap (a RawMemory block) is only touched once it overflows
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class SmallVector
+{
+public:
+
+    static_assert(N > 0, "SmallVector needs at least one inline slot");
+
+    using AllocatorType = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using GrowthPolicy = Growth;
+    using Iterator = T*;
+    using ConstIterator = const T*;
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    SmallVector() noexcept {}
+
+    explicit SmallVector(const Alloc& alloc_) noexcept : heap(alloc_) {}
+
+    explicit SmallVector(size_t size_, const Alloc& alloc_ = Alloc()) : heap(alloc_)
+    {
+        Reserve(size_);
+        vector_detail::UninitializedValueConstructN(heap.GetAllocator(), Buffer(), size_);
+        size = size_;
+    }
+
+    SmallVector(const SmallVector& other_) : heap(AllocTraits::select_on_container_copy_construction(other_.heap.GetAllocator()))
+    {
+        Reserve(other_.size);
+        vector_detail::UninitializedCopyN(heap.GetAllocator(), other_.Buffer(), other_.size, Buffer());
+        size = other_.size;
+    }
+
+    SmallVector(SmallVector&& other_) noexcept(std::is_nothrow_move_constructible_v<T>) : heap(other_.heap.GetAllocator())
+    {
+        StealFrom(other_);
+    }
+
+    SmallVector(std::initializer_list<T> init_list_, const Alloc& alloc_ = Alloc()) : heap(alloc_)
+    {
+        Reserve(init_list_.size());
+        vector_detail::UninitializedCopy(heap.GetAllocator(), init_list_.begin(), init_list_.end(), Buffer());
+        size = init_list_.size();
+    }
+
+    ~SmallVector()
+    {
+        vector_detail::DestroyN(heap.GetAllocator(), Buffer(), size);
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    SmallVector& operator=(const SmallVector& rhs_)
+    {
+        if (this != &rhs_)
+        {
+            if (rhs_.size > Capacity())
+            {
+                Clear();
+                Reserve(rhs_.size);
+                vector_detail::UninitializedCopyN(heap.GetAllocator(), rhs_.Buffer(), rhs_.size, Buffer());
+            }
+            else
+            {
+                size_t copy_size = std::min(size, rhs_.size);
+                std::copy(rhs_.Buffer(), rhs_.Buffer() + copy_size, Buffer());
+
+                if (rhs_.size < size)
+                {
+                    vector_detail::DestroyN(heap.GetAllocator(), Buffer() + rhs_.size, size - rhs_.size);
+                }
+                else
+                {
+                    vector_detail::UninitializedCopyN(heap.GetAllocator(), rhs_.Buffer() + size, rhs_.size - size, Buffer() + size);
+                }
+            }
+            size = rhs_.size;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs_) noexcept(std::is_nothrow_move_constructible_v<T> &&
+        (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value))
+    {
+        if (this != &rhs_)
+        {
+            if (CanAdoptFrom(rhs_))
+            {
+                Clear();
+                // Frees the old block; a propagating allocator is taken over here even when rhs_ is inline
+                heap = RawMemory<T, Alloc>(rhs_.heap.GetAllocator());
+                StealFrom(rhs_);
+            }
+            else
+            {
+                // Unequal allocators that do not propagate: the heap block cannot change hands, so move element-wise
+                Assign(std::make_move_iterator(rhs_.begin()), std::make_move_iterator(rhs_.end()));
+            }
+        }
+        return *this;
+    }
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        return const_cast<SmallVector&>(*this)[index_];
+    }
+
+    T& operator[](size_t index_) noexcept
+    {
+        assert(index_ < size);
+        return Buffer()[index_];
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Buffer();
+    }
+    Iterator end() noexcept
+    {
+        return Buffer() + size;
+    }
+    ConstIterator cbegin() const noexcept
+    {
+        return Buffer();
+    }
+    ConstIterator cend() const noexcept
+    {
+        return Buffer() + size;
+    }
+    ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+    ReverseIterator rbegin() noexcept
+    {
+        return ReverseIterator(end());
+    }
+    ReverseIterator rend() noexcept
+    {
+        return ReverseIterator(begin());
+    }
+    ConstReverseIterator crbegin() const noexcept
+    {
+        return ConstReverseIterator(cend());
+    }
+    ConstReverseIterator crend() const noexcept
+    {
+        return ConstReverseIterator(cbegin());
+    }
+    ConstReverseIterator rbegin() const noexcept
+    {
+        return crbegin();
+    }
+    ConstReverseIterator rend() const noexcept
+    {
+        return crend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return IsInline() ? N : heap.Capacity();
+    }
+
+    static constexpr size_t InlineCapacity() noexcept
+    {
+        return N;
+    }
+
+    bool IsInline() const noexcept
+    {
+        return heap.GetAddress() == nullptr;
+    }
+
+    Alloc Allocator() const noexcept
+    {
+        return heap.GetAllocator();
+    }
+
+    size_t MaxSize() const
+    {
+        return AllocTraits::max_size(heap.GetAllocator());
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    void Clear() noexcept
+    {
+        vector_detail::DestroyN(heap.GetAllocator(), Buffer(), size);
+        size = 0;
+    }
+
+    T& Front() noexcept
+    {
+        assert(size > 0);
+        return Buffer()[0];
+    }
+
+    const T& Front() const noexcept
+    {
+        assert(size > 0);
+        return Buffer()[0];
+    }
+
+    T& Back() noexcept
+    {
+        assert(size > 0);
+        return Buffer()[size - 1];
+    }
+
+    const T& Back() const noexcept
+    {
+        assert(size > 0);
+        return Buffer()[size - 1];
+    }
+
+    Iterator Data() noexcept
+    {
+        return Buffer();
+    }
+
+    ConstIterator Data() const noexcept
+    {
+        return Buffer();
+    }
+
+    T& At(size_t index_)
+    {
+        assert(index_ < size);
+        return Buffer()[index_];
+    }
+
+    const T& At(size_t index_) const
+    {
+        assert(index_ < size);
+        return Buffer()[index_];
+    }
+
+    void Swap(SmallVector& other_) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        const bool blocks_swappable = AllocTraits::propagate_on_container_swap::value || heap.GetAllocator() == other_.heap.GetAllocator();
+        if (!IsInline() && !other_.IsInline() && blocks_swappable)
+        {
+            heap.Swap(other_.heap);
+            std::swap(size, other_.size);
+        }
+        else
+        {
+            SmallVector tmp(std::move(other_));
+            other_ = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
+
+    void Reserve(size_t new_capacity_)
+    {
+        if (new_capacity_ <= Capacity())
+        {
+            return;
+        }
+
+        MoveToHeap(new_capacity_);
+    }
+
+    void Resize(size_t new_size_)
+    {
+        if (new_size_ < size)
+        {
+            vector_detail::DestroyN(heap.GetAllocator(), Buffer() + new_size_, size - new_size_);
+        }
+        else
+        {
+            if (new_size_ > Capacity())
+            {
+                Reserve(GrownCapacity(new_size_));
+            }
+            vector_detail::UninitializedValueConstructN(heap.GetAllocator(), Buffer() + size, new_size_ - size);
+        }
+        size = new_size_;
+    }
+
+    // Moves the elements back into the inline buffer when they fit there
+    void ShrinkToFit()
+    {
+        if (IsInline() || size == heap.Capacity())
+        {
+            return;
+        }
+        if (size <= N)
+        {
+            RawMemory<T, Alloc> old_heap(std::move(heap));
+            heap = RawMemory<T, Alloc>(old_heap.GetAllocator());
+            try
+            {
+                vector_detail::UninitializedRelocateN(heap.GetAllocator(), old_heap.GetAddress(), size, InlineBuffer());
+            }
+            catch (...)
+            {
+                heap = std::move(old_heap);
+                throw;
+            }
+        }
+        else
+        {
+            MoveToHeap(size);
+        }
+    }
+
+    void Assign(std::initializer_list<T> ilist_)
+    {
+        Assign(ilist_.begin(), ilist_.end());
+    }
+
+    Iterator Insert(ConstIterator pos_, const T& item_)
+    {
+        return Emplace(pos_, item_);
+    }
+
+    Iterator Insert(ConstIterator pos_, T&& item_)
+    {
+        return Emplace(pos_, std::move(item_));
+    }
+
+    Iterator Erase(ConstIterator pos_)
+    {
+        assert(pos_ >= begin() && pos_ < end());
+        size_t position = pos_ - begin();
+
+        std::move(begin() + position + 1, end(), begin() + position);
+        vector_detail::DestroyN(heap.GetAllocator(), end() - 1, 1);
+        size -= 1;
+
+        return begin() + position;
+    }
+
+    void PopBack()
+    {
+        assert(size);
+        vector_detail::DestroyN(heap.GetAllocator(), Buffer() + size - 1, 1);
+        --size;
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args_);
+
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos_, Args&&... args_);
+
+    template <typename Type>
+    void PushBack(Type&& value_);
+
+    template <typename InputIt>
+    void Assign(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    void AppendRange(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    Iterator InsertRange(ConstIterator pos_, InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    void AssignRange(InputIt first_, InputIt last_);
+
+    template <typename Predicate>
+    void EraseIf(Predicate pred_);
+
+private:
+
+    RawMemory<T, Alloc> heap;
+    size_t size = 0;
+    alignas(T) unsigned char inline_buffer[N * sizeof(T)];
+
+    T* InlineBuffer() noexcept
+    {
+        return std::launder(reinterpret_cast<T*>(inline_buffer));
+    }
+
+    T* Buffer() noexcept
+    {
+        return IsInline() ? InlineBuffer() : heap.GetAddress();
+    }
+
+    const T* Buffer() const noexcept
+    {
+        return const_cast<SmallVector&>(*this).Buffer();
+    }
+
+    size_t GrownCapacity(size_t required_) const noexcept
+    {
+        return std::max(Growth::NextCapacity(Capacity(), required_, sizeof(T)), required_);
+    }
+
+    // Relocates the elements into a heap block of new_capacity_ slots, leaving gap_count_ free slots at gap_pos_
+    void MoveToHeap(size_t new_capacity_, size_t gap_pos_ = 0, size_t gap_count_ = 0)
+    {
+        RawMemory<T, Alloc> new_heap(new_capacity_, heap.GetAllocator());
+        vector_detail::UninitializedRelocateN(heap.GetAllocator(), Buffer(), size, new_heap.GetAddress(), gap_pos_, gap_count_);
+        heap.Swap(new_heap);
+    }
+
+    // Whether move assignment may take over other_'s heap block: its allocator comes along or can free it
+    bool CanAdoptFrom(const SmallVector& other_) const noexcept
+    {
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+        {
+            return true;
+        }
+        else
+        {
+            return heap.GetAllocator() == other_.heap.GetAllocator();
+        }
+    }
+
+    // Takes other_'s heap block, or relocates its inline elements; this must be empty and inline, other_ is left empty
+    void StealFrom(SmallVector& other_)
+    {
+        assert(size == 0 && IsInline());
+        if (!other_.IsInline())
+        {
+            heap = std::move(other_.heap);
+        }
+        else
+        {
+            vector_detail::UninitializedRelocateN(heap.GetAllocator(), other_.InlineBuffer(), other_.size, InlineBuffer());
+        }
+        size = std::exchange(other_.size, 0);
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename Type>
+void SmallVector<T, N, Alloc, Growth>::PushBack(Type&& value_)
+{
+    EmplaceBack(std::forward<Type>(value_));
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename... Args>
+T& SmallVector<T, N, Alloc, Growth>::EmplaceBack(Args&&... args_)
+{
+    if (size == Capacity())
+    {
+        RawMemory<T, Alloc> new_heap(GrownCapacity(size + 1), heap.GetAllocator());
+        vector_detail::Construct(new_heap.GetAllocator(), new_heap.GetAddress() + size, std::forward<Args>(args_)...);
+        try
+        {
+            vector_detail::UninitializedRelocateN(heap.GetAllocator(), Buffer(), size, new_heap.GetAddress());
+        }
+        catch (...)
+        {
+            vector_detail::DestroyN(new_heap.GetAllocator(), new_heap.GetAddress() + size, 1);
+            throw;
+        }
+        heap.Swap(new_heap);
+    }
+    else
+    {
+        vector_detail::Construct(heap.GetAllocator(), Buffer() + size, std::forward<Args>(args_)...);
+    }
+    return Buffer()[size++];
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename... Args>
+typename SmallVector<T, N, Alloc, Growth>::Iterator SmallVector<T, N, Alloc, Growth>::Emplace(ConstIterator pos_, Args&&... args_)
+{
+    assert(pos_ >= begin() && pos_ <= end());
+    size_t position = pos_ - begin();
+
+    if (position == size)
+    {
+        EmplaceBack(std::forward<Args>(args_)...);
+    }
+    else if (size == Capacity())
+    {
+        RawMemory<T, Alloc> new_heap(GrownCapacity(size + 1), heap.GetAllocator());
+        vector_detail::Construct(new_heap.GetAllocator(), new_heap.GetAddress() + position, std::forward<Args>(args_)...);
+        try
+        {
+            vector_detail::UninitializedRelocateN(heap.GetAllocator(), Buffer(), size, new_heap.GetAddress(), position, 1);
+        }
+        catch (...)
+        {
+            vector_detail::DestroyN(new_heap.GetAllocator(), new_heap.GetAddress() + position, 1);
+            throw;
+        }
+        heap.Swap(new_heap);
+        ++size;
+    }
+    else
+    {
+        T new_item(std::forward<Args>(args_)...);
+        vector_detail::Construct(heap.GetAllocator(), end(), std::move(Back()));
+        ++size;
+        std::move_backward(begin() + position, end() - 2, end() - 1);
+        *(begin() + position) = std::move(new_item);
+    }
+    return begin() + position;
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename InputIt>
+void SmallVector<T, N, Alloc, Growth>::Assign(InputIt first_, InputIt last_)
+{
+    Clear();
+
+    size_t new_size = std::distance(first_, last_);
+    Reserve(new_size);
+    vector_detail::UninitializedCopy(heap.GetAllocator(), first_, last_, Buffer());
+    size = new_size;
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename InputIt>
+void SmallVector<T, N, Alloc, Growth>::AppendRange(InputIt first_, InputIt last_)
+{
+    size_t new_elements_count = std::distance(first_, last_);
+    if (size + new_elements_count > Capacity())
+    {
+        Reserve(GrownCapacity(size + new_elements_count));
+    }
+    vector_detail::UninitializedCopy(heap.GetAllocator(), first_, last_, Buffer() + size);
+    size += new_elements_count;
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename InputIt>
+typename SmallVector<T, N, Alloc, Growth>::Iterator SmallVector<T, N, Alloc, Growth>::InsertRange(ConstIterator pos_, InputIt first_, InputIt last_)
+{
+    assert(pos_ >= begin() && pos_ <= end());
+
+    size_t position = pos_ - begin();
+    size_t new_elements_count = std::distance(first_, last_);
+
+    if (new_elements_count == 0)
+    {
+        return begin() + position;
+    }
+    if (size + new_elements_count > Capacity())
+    {
+        RawMemory<T, Alloc> new_heap(GrownCapacity(size + new_elements_count), heap.GetAllocator());
+        vector_detail::UninitializedCopy(new_heap.GetAllocator(), first_, last_, new_heap.GetAddress() + position);
+        try
+        {
+            vector_detail::UninitializedRelocateN(heap.GetAllocator(), Buffer(), size, new_heap.GetAddress(), position, new_elements_count);
+        }
+        catch (...)
+        {
+            vector_detail::DestroyN(new_heap.GetAllocator(), new_heap.GetAddress() + position, new_elements_count);
+            throw;
+        }
+        heap.Swap(new_heap);
+        size += new_elements_count;
+        return begin() + position;
+    }
+
+    T* insert_at = Buffer() + position;
+    size_t elements_after = size - position;
+
+    if (elements_after > new_elements_count)
+    {
+        vector_detail::UninitializedMoveN(heap.GetAllocator(), end() - new_elements_count, new_elements_count, end());
+        std::move_backward(insert_at, end() - new_elements_count, end());
+        size += new_elements_count;
+        std::copy(first_, last_, insert_at);
+    }
+    else
+    {
+        InputIt middle = std::next(first_, elements_after);
+        vector_detail::UninitializedCopy(heap.GetAllocator(), middle, last_, end());
+        try
+        {
+            vector_detail::UninitializedMoveN(heap.GetAllocator(), insert_at, elements_after, insert_at + new_elements_count);
+        }
+        catch (...)
+        {
+            vector_detail::DestroyN(heap.GetAllocator(), end(), new_elements_count - elements_after);
+            throw;
+        }
+        size += new_elements_count;
+        std::copy(first_, middle, insert_at);
+    }
+    return begin() + position;
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename InputIt>
+void SmallVector<T, N, Alloc, Growth>::AssignRange(InputIt first_, InputIt last_)
+{
+    Assign(first_, last_);
+}
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+template <typename Predicate>
+void SmallVector<T, N, Alloc, Growth>::EraseIf(Predicate pred_)
+{
+    auto new_end = std::remove_if(begin(), end(), pred_);
+    vector_detail::DestroyN(heap.GetAllocator(), new_end, end() - new_end);
+    size = std::distance(begin(), new_end);
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator==(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return vector_detail::RangesEqual(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator!=(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator<(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return vector_detail::RangesLess(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator<=(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return !(rhs_ < lhs_);
+}
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator>(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return rhs_ < lhs_;
+}
+template <typename T, size_t N, typename Alloc, typename Growth>
+inline bool operator>=(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return !(lhs_ < rhs_);
+}
+template <typename T, size_t N, typename Alloc, typename Growth>
+constexpr auto operator<=>(const SmallVector<T, N, Alloc, Growth>& lhs_, const SmallVector<T, N, Alloc, Growth>& rhs_)
+{
+    return vector_detail::RangesThreeWay(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
@@ -0,0 +1,540 @@
+#pragma once
+#include "custom_vector.h"
+#include "allocators.h"
+#include <compare>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+
+// Structure-of-arrays vector: every field type in Ts... lives in its own 64-byte aligned RawMemory column, so a scan over
+// one field only streams that field's bytes. All columns share one size, one capacity and one growth path. Rows are
+// accessed through proxies (std::tuple of references, usable with structured bindings), columns through Data<I>()
+template <typename... Ts>
+class SoAVector
+{
+public:
+
+    static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one column");
+    static_assert((std::is_nothrow_move_constructible_v<Ts> && ...), "columns are relocated one after another, which must not throw");
+
+    static constexpr size_t ColumnCount = sizeof...(Ts);
+    static constexpr size_t ColumnAlignment = 64;
+
+    template <size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    using ValueType = std::tuple<Ts...>;
+    using Reference = std::tuple<Ts&...>;
+    using ConstReference = std::tuple<const Ts&...>;
+
+    template <bool IsConst>
+    class BasicIterator
+    {
+    public:
+
+        // Dereferencing yields a proxy, so this is only an input iterator for the standard algorithms
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, ConstReference, Reference>;
+
+        BasicIterator() noexcept = default;
+
+        BasicIterator(std::conditional_t<IsConst, const SoAVector*, SoAVector*> owner_, size_t index_) noexcept : owner(owner_), index(index_) {}
+
+        // Iterator -> ConstIterator
+        template <bool OtherConst> requires (IsConst && !OtherConst)
+        BasicIterator(const BasicIterator<OtherConst>& other_) noexcept : owner(other_.owner), index(other_.index) {}
+
+        reference operator*() const noexcept
+        {
+            return (*owner)[index];
+        }
+
+        size_t Index() const noexcept
+        {
+            return index;
+        }
+
+        BasicIterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+        BasicIterator operator++(int) noexcept
+        {
+            BasicIterator copy = *this;
+            ++index;
+            return copy;
+        }
+
+        friend BasicIterator operator+(BasicIterator it_, difference_type offset_) noexcept
+        {
+            it_.index += offset_;
+            return it_;
+        }
+        friend difference_type operator-(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return static_cast<difference_type>(lhs_.index) - static_cast<difference_type>(rhs_.index);
+        }
+
+        friend bool operator==(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index == rhs_.index;
+        }
+        friend auto operator<=>(const BasicIterator& lhs_, const BasicIterator& rhs_) noexcept
+        {
+            return lhs_.index <=> rhs_.index;
+        }
+
+    private:
+
+        template <bool>
+        friend class BasicIterator;
+
+        std::conditional_t<IsConst, const SoAVector*, SoAVector*> owner = nullptr;
+        size_t index = 0;
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    SoAVector() = default;
+
+    explicit SoAVector(size_t size_)
+    {
+        Resize(size_);
+    }
+
+    SoAVector(const SoAVector& other_)
+    {
+        CopyFrom(other_);
+    }
+
+    SoAVector(SoAVector&& other_) noexcept
+        : columns(std::move(other_.columns))
+        , size(std::exchange(other_.size, 0))
+        , capacity(std::exchange(other_.capacity, 0)) {}
+
+    SoAVector(std::initializer_list<ValueType> init_list_)
+    {
+        Reserve(init_list_.size());
+        for (const ValueType& row : init_list_)
+        {
+            PushBack(row);
+        }
+    }
+
+    ~SoAVector()
+    {
+        Clear();
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    SoAVector& operator=(const SoAVector& rhs_)
+    {
+        if (this != &rhs_)
+        {
+            Clear();
+            CopyFrom(rhs_);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs_) noexcept
+    {
+        if (this != &rhs_)
+        {
+            Clear();
+            columns = std::move(rhs_.columns);
+            size = std::exchange(rhs_.size, 0);
+            capacity = std::exchange(rhs_.capacity, 0);
+        }
+        return *this;
+    }
+
+    Reference operator[](size_t index_) noexcept
+    {
+        assert(index_ < size);
+        return Row(index_, std::index_sequence_for<Ts...>());
+    }
+
+    ConstReference operator[](size_t index_) const noexcept
+    {
+        assert(index_ < size);
+        return Row(index_, std::index_sequence_for<Ts...>());
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Iterator(this, 0);
+    }
+    Iterator end() noexcept
+    {
+        return Iterator(this, size);
+    }
+
+    ConstIterator cbegin() const noexcept
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator cend() const noexcept
+    {
+        return ConstIterator(this, size);
+    }
+
+    ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return capacity;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    Reference At(size_t index_)
+    {
+        if (index_ >= size)
+        {
+            throw std::out_of_range("SoAVector::At");
+        }
+        return (*this)[index_];
+    }
+    ConstReference At(size_t index_) const
+    {
+        if (index_ >= size)
+        {
+            throw std::out_of_range("SoAVector::At");
+        }
+        return (*this)[index_];
+    }
+
+    Reference Front() noexcept
+    {
+        assert(size);
+        return (*this)[0];
+    }
+    ConstReference Front() const noexcept
+    {
+        assert(size);
+        return (*this)[0];
+    }
+
+    Reference Back() noexcept
+    {
+        assert(size);
+        return (*this)[size - 1];
+    }
+    ConstReference Back() const noexcept
+    {
+        assert(size);
+        return (*this)[size - 1];
+    }
+
+    void Clear() noexcept
+    {
+        DestroyRows(0, size);
+        size = 0;
+    }
+
+    void Swap(SoAVector& other_) noexcept
+    {
+        SwapColumns(other_, std::index_sequence_for<Ts...>());
+        std::swap(size, other_.size);
+        std::swap(capacity, other_.capacity);
+    }
+
+    // Every column is allocated first, so a failed allocation leaves the vector untouched
+    void Reserve(size_t new_capacity_)
+    {
+        if (new_capacity_ > capacity)
+        {
+            Reallocate(new_capacity_, std::index_sequence_for<Ts...>());
+        }
+    }
+
+    void ShrinkToFit()
+    {
+        if (size != capacity)
+        {
+            Reallocate(size, std::index_sequence_for<Ts...>());
+        }
+    }
+
+    // New rows are value-initialized
+    void Resize(size_t new_size_)
+    {
+        if (new_size_ < size)
+        {
+            DestroyRows(new_size_, size);
+            size = new_size_;
+            return;
+        }
+        if (new_size_ > capacity)
+        {
+            Reserve(GrownCapacity(new_size_));
+        }
+        for (; size < new_size_; ++size)
+        {
+            ConstructRow(columns, size, std::index_sequence_for<Ts...>());
+        }
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size);
+        DestroyRows(size - 1, size);
+        --size;
+    }
+
+    void PushBack(const ValueType& row_)
+    {
+        std::apply([this](const Ts&... fields_) { EmplaceBack(fields_...); }, row_);
+    }
+
+    void PushBack(ValueType&& row_)
+    {
+        std::apply([this](Ts&... fields_) { EmplaceBack(std::move(fields_)...); }, row_);
+    }
+
+    // Copies a row proxy, e.g. one taken from another SoAVector
+    template <typename... Us>
+    void PushBack(const std::tuple<Us&...>& row_)
+    {
+        std::apply([this](const Us&... fields_) { EmplaceBack(fields_...); }, row_);
+    }
+
+    Iterator Erase(ConstIterator pos_)
+    {
+        return Erase(pos_, pos_ + 1);
+    }
+
+    // Every column is shifted down over the erased rows
+    Iterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        const size_t first = first_.Index();
+        const size_t last = last_.Index();
+        assert(first <= last && last <= size);
+        if (first != last)
+        {
+            ForEachColumn([&](auto* column_)
+            {
+                std::move(column_ + last, column_ + size, column_ + first);
+            });
+            DestroyRows(size - (last - first), size);
+            size -= last - first;
+        }
+        return Iterator(this, first);
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    // One constructor argument per column
+    template <typename... Args>
+    Reference EmplaceBack(Args&&... args_);
+
+    // Column I as one contiguous, ColumnAlignment-aligned array
+    template <size_t I>
+    std::span<ColumnType<I>> Data() noexcept
+    {
+        return { std::get<I>(columns).GetAddress(), size };
+    }
+
+    template <size_t I>
+    std::span<const ColumnType<I>> Data() const noexcept
+    {
+        return { std::get<I>(columns).GetAddress(), size };
+    }
+
+    // pred_ receives a ConstReference; the kept rows are compacted in every column. Returns the number of erased rows
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred_);
+
+private:
+
+    template <typename T>
+    using Column = RawMemory<T, AlignedAllocator<T, ColumnAlignment>>;
+
+    std::tuple<Column<Ts>...> columns;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    size_t GrownCapacity(size_t required_) const noexcept
+    {
+        return std::max(DoublingGrowth::NextCapacity(capacity, required_, (sizeof(Ts) + ...)), required_);
+    }
+
+    // fn_(T* column) for every column
+    template <typename Function>
+    void ForEachColumn(Function&& fn_)
+    {
+        std::apply([&fn_](auto&... column_) { (fn_(column_.GetAddress()), ...); }, columns);
+    }
+
+    template <size_t... Is>
+    Reference Row(size_t index_, std::index_sequence<Is...>) noexcept
+    {
+        return Reference(std::get<Is>(columns)[index_]...);
+    }
+
+    template <size_t... Is>
+    ConstReference Row(size_t index_, std::index_sequence<Is...>) const noexcept
+    {
+        return ConstReference(std::get<Is>(columns)[index_]...);
+    }
+
+    void DestroyRows(size_t first_, size_t last_) noexcept
+    {
+        std::apply([first_, last_](auto&... column_)
+        {
+            (vector_detail::DestroyN(column_.GetAllocator(), column_.GetAddress() + first_, last_ - first_), ...);
+        }, columns);
+    }
+
+    // Constructs row index_ of columns_ column by column, destroying the finished columns if a later one throws
+    template <size_t... Is, typename... Args>
+    static void ConstructRow(std::tuple<Column<Ts>...>& columns_, size_t index_, std::index_sequence<Is...>, Args&&... args_)
+    {
+        size_t built = 0;
+        try
+        {
+            if constexpr (sizeof...(Args) == 0)
+            {
+                ((vector_detail::Construct(std::get<Is>(columns_).GetAllocator(), std::get<Is>(columns_).GetAddress() + index_), ++built), ...);
+            }
+            else
+            {
+                ((vector_detail::Construct(std::get<Is>(columns_).GetAllocator(), std::get<Is>(columns_).GetAddress() + index_, std::forward<Args>(args_)), ++built), ...);
+            }
+        }
+        catch (...)
+        {
+            ((Is < built ? vector_detail::DestroyN(std::get<Is>(columns_).GetAllocator(), std::get<Is>(columns_).GetAddress() + index_, 1) : void()), ...);
+            throw;
+        }
+    }
+
+    template <size_t... Is>
+    void SwapColumns(SoAVector& other_, std::index_sequence<Is...>) noexcept
+    {
+        (std::get<Is>(columns).Swap(std::get<Is>(other_.columns)), ...);
+    }
+
+    template <size_t... Is>
+    void Reallocate(size_t new_capacity_, std::index_sequence<Is...> sequence_)
+    {
+        std::tuple<Column<Ts>...> new_columns{ Column<Ts>(new_capacity_)... };
+        RelocateInto(new_columns, new_capacity_, sequence_);
+    }
+
+    // Relocates the rows into new_columns_ (allocated for new_capacity_ rows) and adopts them
+    template <size_t... Is>
+    void RelocateInto(std::tuple<Column<Ts>...>& new_columns_, size_t new_capacity_, std::index_sequence<Is...>)
+    {
+        (vector_detail::UninitializedRelocateN(std::get<Is>(columns).GetAllocator(), std::get<Is>(columns).GetAddress(), size, std::get<Is>(new_columns_).GetAddress()), ...);
+        (std::get<Is>(columns).Swap(std::get<Is>(new_columns_)), ...);
+        capacity = new_capacity_;
+    }
+
+    void CopyFrom(const SoAVector& other_)
+    {
+        Reserve(other_.size);
+        for (ConstReference row : other_)
+        {
+            PushBack(row);
+        }
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename... Ts>
+template <typename... Args>
+typename SoAVector<Ts...>::Reference SoAVector<Ts...>::EmplaceBack(Args&&... args_)
+{
+    static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack takes one argument per column");
+    if (size == capacity)
+    {
+        // args_ may refer into the current columns (PushBack(v[0])), so the row is built in the new columns before the
+        // old rows are relocated and freed
+        const size_t new_capacity = GrownCapacity(size + 1);
+        std::tuple<Column<Ts>...> new_columns{ Column<Ts>(new_capacity)... };
+        ConstructRow(new_columns, size, std::index_sequence_for<Ts...>(), std::forward<Args>(args_)...);
+        try
+        {
+            RelocateInto(new_columns, new_capacity, std::index_sequence_for<Ts...>());
+        }
+        catch (...)
+        {
+            std::apply([this](auto&... column_)
+            {
+                (vector_detail::DestroyN(column_.GetAllocator(), column_.GetAddress() + size, 1), ...);
+            }, new_columns);
+            throw;
+        }
+    }
+    else
+    {
+        ConstructRow(columns, size, std::index_sequence_for<Ts...>(), std::forward<Args>(args_)...);
+    }
+    ++size;
+    return (*this)[size - 1];
+}
+
+template <typename... Ts>
+template <typename Predicate>
+size_t SoAVector<Ts...>::EraseIf(Predicate pred_)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (pred_(std::as_const(*this)[i]))
+        {
+            continue;
+        }
+        if (kept != i)
+        {
+            ForEachColumn([kept, i](auto* column_) { column_[kept] = std::move(column_[i]); });
+        }
+        ++kept;
+    }
+    const size_t erased = size - kept;
+    DestroyRows(kept, size);
+    size = kept;
+    return erased;
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename... Ts>
+inline bool operator==(const SoAVector<Ts...>& lhs_, const SoAVector<Ts...>& rhs_)
+{
+    return lhs_.Size() == rhs_.Size() && std::equal(lhs_.begin(), lhs_.end(), rhs_.begin());
+}
+template <typename... Ts>
+inline bool operator!=(const SoAVector<Ts...>& lhs_, const SoAVector<Ts...>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
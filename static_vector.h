@@ -0,0 +1,545 @@
+#pragma once
+#include "custom_vector.h"
+#include <stdexcept>
+
+// Vector with a fixed capacity of N elements stored inside the object; it never allocates. Growing past N throws
+// std::length_error before anything is modified, and TryPushBack/TryEmplaceBack report a full vector instead of throwing.
+// For trivially copyable T the whole object is trivially copyable as well
+template <typename T, size_t N>
+class StaticVector
+{
+public:
+
+    static_assert(N > 0, "StaticVector needs at least one slot");
+
+    using ValueType = T;
+    using Iterator = T*;
+    using ConstIterator = const T*;
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+    using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+    //-------------------------------------------------------------Constructors & Destructor----------------------------------------------------
+
+    StaticVector() noexcept {}
+
+    explicit StaticVector(size_t size_)
+    {
+        CheckFits(size_);
+        vector_detail::UninitializedValueConstructN(constructor, Buffer(), size_);
+        size = size_;
+    }
+
+    StaticVector(const StaticVector&) requires std::is_trivially_copyable_v<T> = default;
+
+    StaticVector(const StaticVector& other_)
+    {
+        vector_detail::UninitializedCopyN(constructor, other_.Buffer(), other_.size, Buffer());
+        size = other_.size;
+    }
+
+    StaticVector(StaticVector&&) requires std::is_trivially_copyable_v<T> = default;
+
+    // The elements are moved one by one; other_ keeps its (moved-from) elements, like std::inplace_vector
+    StaticVector(StaticVector&& other_) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        vector_detail::UninitializedMoveN(constructor, other_.Buffer(), other_.size, Buffer());
+        size = other_.size;
+    }
+
+    StaticVector(std::initializer_list<T> init_list_)
+    {
+        CheckFits(init_list_.size());
+        vector_detail::UninitializedCopy(constructor, init_list_.begin(), init_list_.end(), Buffer());
+        size = init_list_.size();
+    }
+
+    ~StaticVector() requires std::is_trivially_destructible_v<T> = default;
+
+    ~StaticVector()
+    {
+        Clear();
+    }
+
+    //----------------------------------------------------------------------Operators----------------------------------------------------------
+
+    StaticVector& operator=(const StaticVector&) requires std::is_trivially_copyable_v<T> = default;
+
+    StaticVector& operator=(const StaticVector& rhs_)
+    {
+        if (this != &rhs_)
+        {
+            AssignFrom(rhs_.Buffer(), rhs_.size);
+        }
+        return *this;
+    }
+
+    StaticVector& operator=(StaticVector&&) requires std::is_trivially_copyable_v<T> = default;
+
+    StaticVector& operator=(StaticVector&& rhs_) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &rhs_)
+        {
+            AssignFrom(std::make_move_iterator(rhs_.Buffer()), rhs_.size);
+        }
+        return *this;
+    }
+
+    const T& operator[](size_t index_) const noexcept
+    {
+        return const_cast<StaticVector&>(*this)[index_];
+    }
+
+    T& operator[](size_t index_) noexcept
+    {
+        assert(index_ < size);
+        return Buffer()[index_];
+    }
+
+    //------------------------------------------------------------------------Iterators---------------------------------------------------------
+
+    Iterator begin() noexcept
+    {
+        return Buffer();
+    }
+    Iterator end() noexcept
+    {
+        return Buffer() + size;
+    }
+    ConstIterator cbegin() const noexcept
+    {
+        return Buffer();
+    }
+    ConstIterator cend() const noexcept
+    {
+        return Buffer() + size;
+    }
+    ConstIterator begin() const noexcept
+    {
+        return cbegin();
+    }
+    ConstIterator end() const noexcept
+    {
+        return cend();
+    }
+    ReverseIterator rbegin() noexcept
+    {
+        return ReverseIterator(end());
+    }
+    ReverseIterator rend() noexcept
+    {
+        return ReverseIterator(begin());
+    }
+    ConstReverseIterator crbegin() const noexcept
+    {
+        return ConstReverseIterator(cend());
+    }
+    ConstReverseIterator crend() const noexcept
+    {
+        return ConstReverseIterator(cbegin());
+    }
+    ConstReverseIterator rbegin() const noexcept
+    {
+        return crbegin();
+    }
+    ConstReverseIterator rend() const noexcept
+    {
+        return crend();
+    }
+
+    //-----------------------------------------------------------------Non-Template Methods------------------------------------------------------
+
+    size_t Size() const noexcept
+    {
+        return size;
+    }
+
+    static constexpr size_t Capacity() noexcept
+    {
+        return N;
+    }
+
+    static constexpr size_t MaxSize() noexcept
+    {
+        return N;
+    }
+
+    bool IsEmpty() const noexcept
+    {
+        return size == 0;
+    }
+
+    bool IsFull() const noexcept
+    {
+        return size == N;
+    }
+
+    void Clear() noexcept
+    {
+        vector_detail::DestroyN(constructor, Buffer(), size);
+        size = 0;
+    }
+
+    T& Front() noexcept
+    {
+        assert(size > 0);
+        return Buffer()[0];
+    }
+
+    const T& Front() const noexcept
+    {
+        assert(size > 0);
+        return Buffer()[0];
+    }
+
+    T& Back() noexcept
+    {
+        assert(size > 0);
+        return Buffer()[size - 1];
+    }
+
+    const T& Back() const noexcept
+    {
+        assert(size > 0);
+        return Buffer()[size - 1];
+    }
+
+    Iterator Data() noexcept
+    {
+        return Buffer();
+    }
+
+    ConstIterator Data() const noexcept
+    {
+        return Buffer();
+    }
+
+    T& At(size_t index_)
+    {
+        assert(index_ < size);
+        return Buffer()[index_];
+    }
+
+    const T& At(size_t index_) const
+    {
+        assert(index_ < size);
+        return Buffer()[index_];
+    }
+
+    void Swap(StaticVector& other_) noexcept(std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>)
+    {
+        StaticVector& shorter = size <= other_.size ? *this : other_;
+        StaticVector& longer = size <= other_.size ? other_ : *this;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        vector_detail::UninitializedMoveN(constructor, longer.Buffer() + shorter.size, longer.size - shorter.size, shorter.end());
+        vector_detail::DestroyN(constructor, longer.Buffer() + shorter.size, longer.size - shorter.size);
+        std::swap(size, other_.size);
+    }
+
+    void Resize(size_t new_size_)
+    {
+        CheckFits(new_size_);
+        if (new_size_ < size)
+        {
+            vector_detail::DestroyN(constructor, Buffer() + new_size_, size - new_size_);
+        }
+        else
+        {
+            vector_detail::UninitializedValueConstructN(constructor, Buffer() + size, new_size_ - size);
+        }
+        size = new_size_;
+    }
+
+    void Assign(std::initializer_list<T> ilist_)
+    {
+        Assign(ilist_.begin(), ilist_.end());
+    }
+
+    Iterator Insert(ConstIterator pos_, const T& item_)
+    {
+        return Emplace(pos_, item_);
+    }
+
+    Iterator Insert(ConstIterator pos_, T&& item_)
+    {
+        return Emplace(pos_, std::move(item_));
+    }
+
+    Iterator Erase(ConstIterator pos_)
+    {
+        return Erase(pos_, pos_ + 1);
+    }
+
+    Iterator Erase(ConstIterator first_, ConstIterator last_)
+    {
+        assert(first_ >= begin() && first_ <= last_ && last_ <= end());
+        const size_t position = first_ - begin();
+        const size_t count = last_ - first_;
+        if (count != 0)
+        {
+            std::move(begin() + position + count, end(), begin() + position);
+            vector_detail::DestroyN(constructor, end() - count, count);
+            size -= count;
+        }
+        return begin() + position;
+    }
+
+    void PopBack()
+    {
+        assert(size);
+        vector_detail::DestroyN(constructor, Buffer() + size - 1, 1);
+        --size;
+    }
+
+    bool TryPushBack(const T& value_)
+    {
+        return TryEmplaceBack(value_) != nullptr;
+    }
+
+    bool TryPushBack(T&& value_)
+    {
+        return TryEmplaceBack(std::move(value_)) != nullptr;
+    }
+
+    //------------------------------------------------------------------Template Metods----------------------------------------------------------
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args_);
+
+    // Returns the new element, or nullptr (constructing nothing) when the vector is full
+    template <typename... Args>
+    T* TryEmplaceBack(Args&&... args_);
+
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos_, Args&&... args_);
+
+    template <typename Type>
+    void PushBack(Type&& value_);
+
+    template <typename InputIt>
+    void Assign(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    void AppendRange(InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    Iterator InsertRange(ConstIterator pos_, InputIt first_, InputIt last_);
+
+    template <typename InputIt>
+    void AssignRange(InputIt first_, InputIt last_);
+
+    template <typename Predicate>
+    void EraseIf(Predicate pred_);
+
+private:
+
+    // Only used for construct/destroy; std::allocator is stateless and nothing is ever allocated through it
+    static inline std::allocator<T> constructor;
+
+    size_t size = 0;
+    alignas(T) unsigned char storage[N * sizeof(T)];
+
+    T* Buffer() noexcept
+    {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    const T* Buffer() const noexcept
+    {
+        return const_cast<StaticVector&>(*this).Buffer();
+    }
+
+    static void CheckFits(size_t count_)
+    {
+        if (count_ > N)
+        {
+            throw std::length_error("StaticVector: capacity exceeded");
+        }
+    }
+
+    template <typename It>
+    void AssignFrom(It first_, size_t count_)
+    {
+        const size_t common = std::min(size, count_);
+        for (size_t i = 0; i < common; ++i, ++first_)
+        {
+            Buffer()[i] = *first_;
+        }
+        if (count_ < size)
+        {
+            vector_detail::DestroyN(constructor, Buffer() + count_, size - count_);
+        }
+        else
+        {
+            vector_detail::UninitializedCopyN(constructor, first_, count_ - size, Buffer() + size);
+        }
+        size = count_;
+    }
+};
+
+//----------------------------------------------------------------Implementing Template Methods--------------------------------------------
+
+template <typename T, size_t N>
+template <typename Type>
+void StaticVector<T, N>::PushBack(Type&& value_)
+{
+    EmplaceBack(std::forward<Type>(value_));
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+T& StaticVector<T, N>::EmplaceBack(Args&&... args_)
+{
+    CheckFits(size + 1);
+    T* slot = Buffer() + size;
+    vector_detail::Construct(constructor, slot, std::forward<Args>(args_)...);
+    ++size;
+    return *slot;
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+T* StaticVector<T, N>::TryEmplaceBack(Args&&... args_)
+{
+    if (size == N)
+    {
+        return nullptr;
+    }
+    T* slot = Buffer() + size;
+    vector_detail::Construct(constructor, slot, std::forward<Args>(args_)...);
+    ++size;
+    return slot;
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+typename StaticVector<T, N>::Iterator StaticVector<T, N>::Emplace(ConstIterator pos_, Args&&... args_)
+{
+    assert(pos_ >= begin() && pos_ <= end());
+    const size_t position = pos_ - begin();
+    CheckFits(size + 1);
+
+    if (position == size)
+    {
+        EmplaceBack(std::forward<Args>(args_)...);
+    }
+    else
+    {
+        T new_item(std::forward<Args>(args_)...);
+        vector_detail::Construct(constructor, end(), std::move(Back()));
+        ++size;
+        std::move_backward(begin() + position, end() - 2, end() - 1);
+        *(begin() + position) = std::move(new_item);
+    }
+    return begin() + position;
+}
+
+template <typename T, size_t N>
+template <typename InputIt>
+void StaticVector<T, N>::Assign(InputIt first_, InputIt last_)
+{
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        const size_t count = std::distance(first_, last_);
+        CheckFits(count);
+        AssignFrom(first_, count);
+    }
+    else
+    {
+        Clear();
+        AppendRange(first_, last_);
+    }
+}
+
+// Multi-pass ranges are checked against the capacity up front; single-pass ones throw once the vector is full,
+// keeping the elements appended so far
+template <typename T, size_t N>
+template <typename InputIt>
+void StaticVector<T, N>::AppendRange(InputIt first_, InputIt last_)
+{
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        const size_t count = std::distance(first_, last_);
+        CheckFits(size + count);
+        vector_detail::UninitializedCopyN(constructor, first_, count, end());
+        size += count;
+    }
+    else
+    {
+        for (; first_ != last_; ++first_)
+        {
+            EmplaceBack(*first_);
+        }
+    }
+}
+
+template <typename T, size_t N>
+template <typename InputIt>
+typename StaticVector<T, N>::Iterator StaticVector<T, N>::InsertRange(ConstIterator pos_, InputIt first_, InputIt last_)
+{
+    assert(pos_ >= begin() && pos_ <= end());
+    const size_t position = pos_ - begin();
+    const size_t old_size = size;
+
+    if constexpr (vector_detail::MultiPassIterator<InputIt>)
+    {
+        CheckFits(size + std::distance(first_, last_));
+    }
+    // Append, then rotate the new elements into place
+    AppendRange(first_, last_);
+    std::rotate(begin() + position, begin() + old_size, end());
+    return begin() + position;
+}
+
+template <typename T, size_t N>
+template <typename InputIt>
+void StaticVector<T, N>::AssignRange(InputIt first_, InputIt last_)
+{
+    Assign(first_, last_);
+}
+
+template <typename T, size_t N>
+template <typename Predicate>
+void StaticVector<T, N>::EraseIf(Predicate pred_)
+{
+    auto new_end = std::remove_if(begin(), end(), pred_);
+    vector_detail::DestroyN(constructor, new_end, end() - new_end);
+    size = new_end - begin();
+}
+
+//-----------------------------------------------------------Implementation of Comparison Operators------------------------------------------
+
+template <typename T, size_t N>
+inline bool operator==(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return vector_detail::RangesEqual(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
+template <typename T, size_t N>
+inline bool operator!=(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return !(lhs_ == rhs_);
+}
+template <typename T, size_t N>
+inline bool operator<(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return vector_detail::RangesLess(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
+template <typename T, size_t N>
+inline bool operator<=(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return !(rhs_ < lhs_);
+}
+template <typename T, size_t N>
+inline bool operator>(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return rhs_ < lhs_;
+}
+template <typename T, size_t N>
+inline bool operator>=(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return !(lhs_ < rhs_);
+}
+template <typename T, size_t N>
+constexpr auto operator<=>(const StaticVector<T, N>& lhs_, const StaticVector<T, N>& rhs_)
+{
+    return vector_detail::RangesThreeWay(lhs_.Data(), lhs_.Size(), rhs_.Data(), rhs_.Size());
+}
@@ -0,0 +1,380 @@
+// Google Benchmark suite comparing Vector with std::vector.
+// Build: g++ -O2 -std=c++20 vector_benchmark.cpp -lbenchmark -lpthread
+#include "custom_vector.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------Element Types----------------------------------------------------------
+
+// Trivially copyable record
+struct Pod
+{
+    int64_t key;
+    double value;
+
+    friend bool operator==(const Pod& lhs_, const Pod& rhs_) noexcept
+    {
+        return lhs_.key == rhs_.key && lhs_.value == rhs_.value;
+    }
+    friend bool operator<(const Pod& lhs_, const Pod& rhs_) noexcept
+    {
+        return lhs_.key < rhs_.key;
+    }
+};
+
+// Owns heap memory and has a noexcept move (std::string longer than the SSO buffer)
+using NothrowMove = std::string;
+
+// Byte keys, which the comparison operators hand to memcmp
+using Byte = uint8_t;
+
+// Has a copy constructor but no move constructor, so every relocation copies
+struct CopyOnly
+{
+    std::string text;
+
+    CopyOnly() = default;
+    explicit CopyOnly(std::string text_) : text(std::move(text_)) {}
+    CopyOnly(const CopyOnly& other_) : text(other_.text) {}
+    CopyOnly& operator=(const CopyOnly& rhs_)
+    {
+        text = rhs_.text;
+        return *this;
+    }
+
+    friend bool operator==(const CopyOnly& lhs_, const CopyOnly& rhs_)
+    {
+        return lhs_.text == rhs_.text;
+    }
+    friend bool operator<(const CopyOnly& lhs_, const CopyOnly& rhs_)
+    {
+        return lhs_.text < rhs_.text;
+    }
+};
+
+template <typename T>
+T MakeValue(size_t i_)
+{
+    if constexpr (std::is_same_v<T, Pod>)
+    {
+        return Pod{ static_cast<int64_t>(i_), static_cast<double>(i_) };
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        return static_cast<T>(i_);
+    }
+    else
+    {
+        return T("benchmark payload that does not fit into SSO #" + std::to_string(i_));
+    }
+}
+
+//--------------------------------------------------------------Container Adapters--------------------------------------------------------
+
+// Gives Vector the std::vector spellings the benchmark bodies need, so one template covers both containers
+template <typename T>
+struct BenchVector : Vector<T>
+{
+    using value_type = T;
+    using Vector<T>::Vector;
+
+    const T* data() const noexcept
+    {
+        return this->Data();
+    }
+};
+
+template <typename T>
+void PushBack(BenchVector<T>& c_, const T& value_)
+{
+    c_.PushBack(value_);
+}
+template <typename T>
+void PushBack(std::vector<T>& c_, const T& value_)
+{
+    c_.push_back(value_);
+}
+
+template <typename T>
+void EmplaceBack(BenchVector<T>& c_, T&& value_)
+{
+    c_.EmplaceBack(std::move(value_));
+}
+template <typename T>
+void EmplaceBack(std::vector<T>& c_, T&& value_)
+{
+    c_.emplace_back(std::move(value_));
+}
+
+template <typename T>
+void Reserve(BenchVector<T>& c_, size_t n_)
+{
+    c_.Reserve(n_);
+}
+template <typename T>
+void Reserve(std::vector<T>& c_, size_t n_)
+{
+    c_.reserve(n_);
+}
+
+template <typename T>
+void InsertMiddle(BenchVector<T>& c_, const T& value_)
+{
+    c_.Insert(c_.begin() + c_.Size() / 2, value_);
+}
+template <typename T>
+void InsertMiddle(std::vector<T>& c_, const T& value_)
+{
+    c_.insert(c_.begin() + c_.size() / 2, value_);
+}
+
+template <typename T>
+void EmplaceMiddle(BenchVector<T>& c_, T&& value_)
+{
+    c_.Emplace(c_.begin() + c_.Size() / 2, std::move(value_));
+}
+template <typename T>
+void EmplaceMiddle(std::vector<T>& c_, T&& value_)
+{
+    c_.emplace(c_.begin() + c_.size() / 2, std::move(value_));
+}
+
+template <typename T>
+void InsertRangeMiddle(BenchVector<T>& c_, const T* first_, const T* last_)
+{
+    c_.InsertRange(c_.begin() + c_.Size() / 2, first_, last_);
+}
+template <typename T>
+void InsertRangeMiddle(std::vector<T>& c_, const T* first_, const T* last_)
+{
+    c_.insert(c_.begin() + c_.size() / 2, first_, last_);
+}
+
+template <typename T, typename Predicate>
+void EraseIf(BenchVector<T>& c_, Predicate pred_)
+{
+    c_.EraseIf(pred_);
+}
+template <typename T, typename Predicate>
+void EraseIf(std::vector<T>& c_, Predicate pred_)
+{
+    std::erase_if(c_, pred_);
+}
+
+// Filled through Reserve + PushBack, so Capacity() == Size() for both containers
+template <typename Container>
+Container MakeFilled(size_t n_)
+{
+    using T = typename Container::value_type;
+    Container c;
+    Reserve(c, n_);
+    for (size_t i = 0; i < n_; ++i)
+    {
+        PushBack(c, MakeValue<T>(i));
+    }
+    return c;
+}
+
+//----------------------------------------------------------------------Benchmarks---------------------------------------------------------
+
+template <typename Container>
+void BM_PushBackGrowth(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    const T value = MakeValue<T>(42);
+    for (auto _ : state_)
+    {
+        Container c;
+        for (size_t i = 0; i < n; ++i)
+        {
+            PushBack(c, value);
+        }
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+template <typename Container>
+void BM_EmplaceBackGrowth(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    for (auto _ : state_)
+    {
+        Container c;
+        for (size_t i = 0; i < n; ++i)
+        {
+            EmplaceBack(c, MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+template <typename Container>
+void BM_ReserveFill(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    const T value = MakeValue<T>(42);
+    for (auto _ : state_)
+    {
+        Container c;
+        Reserve(c, n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            PushBack(c, value);
+        }
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+template <typename Container>
+void BM_InsertMiddle(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    const T value = MakeValue<T>(7);
+    for (auto _ : state_)
+    {
+        state_.PauseTiming();
+        Container c = MakeFilled<Container>(n);
+        state_.ResumeTiming();
+        for (size_t i = 0; i < 16; ++i)
+        {
+            InsertMiddle(c, value);
+        }
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * 16);
+}
+
+template <typename Container>
+void BM_EmplaceMiddle(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    for (auto _ : state_)
+    {
+        state_.PauseTiming();
+        Container c = MakeFilled<Container>(n);
+        state_.ResumeTiming();
+        for (size_t i = 0; i < 16; ++i)
+        {
+            EmplaceMiddle(c, MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * 16);
+}
+
+template <typename Container>
+void BM_InsertRange(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    std::vector<T> batch;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        batch.push_back(MakeValue<T>(i));
+    }
+    for (auto _ : state_)
+    {
+        state_.PauseTiming();
+        Container c = MakeFilled<Container>(n);
+        state_.ResumeTiming();
+        InsertRangeMiddle(c, batch.data(), batch.data() + batch.size());
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * batch.size());
+}
+
+template <typename Container>
+void BM_EraseIf(benchmark::State& state_)
+{
+    using T = typename Container::value_type;
+    const size_t n = state_.range(0);
+    const T pivot = MakeValue<T>(n / 2);
+    for (auto _ : state_)
+    {
+        state_.PauseTiming();
+        Container c = MakeFilled<Container>(n);
+        state_.ResumeTiming();
+        EraseIf(c, [&pivot](const T& item_) { return item_ < pivot; });
+        benchmark::DoNotOptimize(c.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+// Assigning into a container whose capacity already fits the source, so no allocation should happen
+template <typename Container>
+void BM_CopyAssignReuse(benchmark::State& state_)
+{
+    const size_t n = state_.range(0);
+    const Container source = MakeFilled<Container>(n);
+    Container target = MakeFilled<Container>(n);
+    for (auto _ : state_)
+    {
+        target = source;
+        benchmark::DoNotOptimize(target.data());
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+template <typename Container>
+void BM_Equal(benchmark::State& state_)
+{
+    const size_t n = state_.range(0);
+    const Container lhs = MakeFilled<Container>(n);
+    const Container rhs = MakeFilled<Container>(n);
+    for (auto _ : state_)
+    {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+template <typename Container>
+void BM_Less(benchmark::State& state_)
+{
+    const size_t n = state_.range(0);
+    const Container lhs = MakeFilled<Container>(n);
+    const Container rhs = MakeFilled<Container>(n);
+    for (auto _ : state_)
+    {
+        benchmark::DoNotOptimize(lhs < rhs);
+    }
+    state_.SetItemsProcessed(state_.iterations() * n);
+}
+
+//---------------------------------------------------------------------Registration--------------------------------------------------------
+
+#define VECTOR_BENCHMARK_SIZES RangeMultiplier(8)->Range(8, 1 << 18)
+
+#define VECTOR_BENCHMARK_FOR_TYPE(Name, Type)                                   \
+    BENCHMARK_TEMPLATE(Name, BenchVector<Type>)->VECTOR_BENCHMARK_SIZES;        \
+    BENCHMARK_TEMPLATE(Name, std::vector<Type>)->VECTOR_BENCHMARK_SIZES
+
+#define VECTOR_BENCHMARK(Name)                                                  \
+    VECTOR_BENCHMARK_FOR_TYPE(Name, Pod);                                       \
+    VECTOR_BENCHMARK_FOR_TYPE(Name, NothrowMove);                               \
+    VECTOR_BENCHMARK_FOR_TYPE(Name, CopyOnly)
+
+VECTOR_BENCHMARK(BM_PushBackGrowth);
+VECTOR_BENCHMARK(BM_EmplaceBackGrowth);
+VECTOR_BENCHMARK(BM_ReserveFill);
+VECTOR_BENCHMARK(BM_InsertMiddle);
+VECTOR_BENCHMARK(BM_EmplaceMiddle);
+VECTOR_BENCHMARK(BM_InsertRange);
+VECTOR_BENCHMARK(BM_EraseIf);
+VECTOR_BENCHMARK(BM_CopyAssignReuse);
+VECTOR_BENCHMARK(BM_Equal);
+VECTOR_BENCHMARK(BM_Less);
+VECTOR_BENCHMARK_FOR_TYPE(BM_Equal, Byte);
+VECTOR_BENCHMARK_FOR_TYPE(BM_Less, Byte);
+
+BENCHMARK_MAIN();
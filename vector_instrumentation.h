@@ -0,0 +1,181 @@
+#pragma once
+// Opt-in allocation statistics for Vector. Define VECTOR_ENABLE_INSTRUMENTATION before including custom_vector.h to turn
+// them on; otherwise every hook below expands to nothing and Vector compiles exactly as without this header.
+
+#if defined(VECTOR_ENABLE_INSTRUMENTATION)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <vector>
+
+namespace vector_instrumentation
+{
+    enum class EventKind
+    {
+        Allocation,   // a block was acquired while no elements had to be carried over
+        Reallocation  // the elements were relocated into a differently sized block
+    };
+
+    struct Event
+    {
+        EventKind kind;
+        const char* container;      // the Vector instantiation, as spelled by the compiler
+        size_t element_size;
+        size_t old_capacity;
+        size_t new_capacity;
+        size_t size;                // element count at the time of the event
+        size_t bytes_relocated;     // bytes moved or copied into the new block
+        std::source_location call_site; // line() == 0 when the operation was not tagged by the caller
+    };
+
+    // Running totals for one Vector instantiation
+    struct Counters
+    {
+        const char* container = "";
+        size_t element_size = 0;
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> reallocations{ 0 };
+        std::atomic<uint64_t> bytes_relocated{ 0 };
+        std::atomic<uint64_t> peak_capacity{ 0 };
+        std::atomic<uint64_t> peak_slack_bytes{ 0 };
+    };
+
+    using Callback = void (*)(const Event& event_, void* user_data_);
+
+    // Process-wide list of every instantiation that has allocated so far, plus an optional per-event callback
+    class Registry
+    {
+    public:
+
+        static Registry& Instance()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        void Register(Counters* counters_)
+        {
+            std::lock_guard lock(mutex);
+            counters.push_back(counters_);
+        }
+
+        // fn_(const Counters&) is called for every registered instantiation; meant for periodic scraping into metrics
+        template <typename Function>
+        void ForEach(Function fn_) const
+        {
+            std::lock_guard lock(mutex);
+            for (const Counters* entry : counters)
+            {
+                fn_(*entry);
+            }
+        }
+
+        void SetCallback(Callback callback_, void* user_data_ = nullptr)
+        {
+            std::lock_guard lock(mutex);
+            user_data.store(user_data_, std::memory_order_relaxed);
+            callback.store(callback_, std::memory_order_release);
+        }
+
+        void Notify(const Event& event_) const
+        {
+            if (Callback current = callback.load(std::memory_order_acquire))
+            {
+                current(event_, user_data.load(std::memory_order_relaxed));
+            }
+        }
+
+    private:
+
+        Registry() = default;
+
+        mutable std::mutex mutex;
+        std::vector<Counters*> counters;
+        std::atomic<Callback> callback{ nullptr };
+        std::atomic<void*> user_data{ nullptr };
+    };
+
+    template <typename Container>
+    Counters& CountersFor()
+    {
+        static Counters counters{ std::source_location::current().function_name(), sizeof(typename Container::ValueType) };
+        static const bool registered = (Registry::Instance().Register(&counters), true);
+        (void)registered;
+        return counters;
+    }
+
+    inline void UpdateMax(std::atomic<uint64_t>& peak_, uint64_t value_) noexcept
+    {
+        uint64_t current = peak_.load(std::memory_order_relaxed);
+        while (current < value_ && !peak_.compare_exchange_weak(current, value_, std::memory_order_relaxed)) {}
+    }
+
+    template <typename Container>
+    void Record(size_t old_capacity_, size_t new_capacity_, size_t size_, size_t relocated_count_, std::source_location call_site_)
+    {
+        Counters& counters = CountersFor<Container>();
+        const Event event{
+            old_capacity_ == 0 || relocated_count_ == 0 ? EventKind::Allocation : EventKind::Reallocation,
+            counters.container,
+            counters.element_size,
+            old_capacity_,
+            new_capacity_,
+            size_,
+            relocated_count_ * counters.element_size,
+            call_site_
+        };
+
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        if (event.kind == EventKind::Reallocation)
+        {
+            counters.reallocations.fetch_add(1, std::memory_order_relaxed);
+            counters.bytes_relocated.fetch_add(event.bytes_relocated, std::memory_order_relaxed);
+        }
+        UpdateMax(counters.peak_capacity, new_capacity_);
+        if (new_capacity_ > size_)
+        {
+            UpdateMax(counters.peak_slack_bytes, (new_capacity_ - size_) * counters.element_size);
+        }
+        Registry::Instance().Notify(event);
+    }
+
+    // Implicitly built from an iterator at the caller's side, so Emplace can pick up the call site despite its parameter pack
+    template <typename ConstIterator>
+    struct TaggedPosition
+    {
+        constexpr TaggedPosition(ConstIterator pos_, std::source_location call_site_ = std::source_location::current()) noexcept
+            : pos(pos_), call_site(call_site_) {}
+
+        constexpr operator ConstIterator() const noexcept
+        {
+            return pos;
+        }
+
+        ConstIterator pos;
+        std::source_location call_site;
+    };
+}
+
+#define VECTOR_INSTRUMENT(...) __VA_ARGS__
+// Trailing parameter for public declarations: callers are tagged automatically
+#define VECTOR_CALL_SITE_TAG , std::source_location call_site_ = std::source_location::current()
+// Trailing parameter for internal declarations: untagged unless a caller forwards its own tag
+#define VECTOR_CALL_SITE_UNTAGGED , std::source_location call_site_ = std::source_location()
+// Trailing parameter for out-of-class definitions
+#define VECTOR_CALL_SITE_PARAM , std::source_location call_site_
+#define VECTOR_CALL_SITE_FORWARD , call_site_
+#define VECTOR_EMPLACE_POSITION(ConstIterator) vector_instrumentation::TaggedPosition<ConstIterator>
+
+#else
+
+#define VECTOR_INSTRUMENT(...)
+#define VECTOR_CALL_SITE_TAG
+#define VECTOR_CALL_SITE_UNTAGGED
+#define VECTOR_CALL_SITE_PARAM
+#define VECTOR_CALL_SITE_FORWARD
+#define VECTOR_EMPLACE_POSITION(ConstIterator) ConstIterator
+
+#endif
@@ -0,0 +1,424 @@
+#pragma once
+// Binary serialization for Vector. Trivially copyable elements are stored as the raw Data() block behind a small header,
+// written with one writev and read straight into uninitialized capacity; other element types go through ElementSerializer.
+// AppendFromFd streams raw elements from a descriptor into spare capacity without an intermediate buffer.
+
+#include "custom_vector.h"
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Identifies the element type in a serialized block; specialize it with a stable value for record types
+template <typename T>
+struct SerializedTypeTag : std::integral_constant<uint64_t, (uint64_t(sizeof(T)) << 32) | uint64_t(alignof(T))> {};
+
+// Customization point for element types that cannot be stored as raw bytes. A specialization provides
+//     template <typename Sink> static void Write(Sink& sink_, const T& value_);
+//     template <typename Source> static T Read(Source& source_);
+// where sink_.Write(const void*, size_t) and source_.Read(void*, size_t) move raw bytes. Specializing it for a trivially
+// copyable type replaces the raw block format as well
+template <typename T>
+struct ElementSerializer
+{
+    using IsDefault = void;
+};
+
+namespace vector_io
+{
+    enum class Endian : uint8_t
+    {
+        Little = 1,
+        Big = 2
+    };
+
+    inline constexpr Endian NativeEndian = std::endian::native == std::endian::little ? Endian::Little : Endian::Big;
+
+    struct Header
+    {
+        static constexpr uint32_t Magic = 0x56454331; // "VEC1"
+        static constexpr uint16_t CurrentVersion = 1;
+
+        uint32_t magic = Magic;
+        uint16_t version = CurrentVersion;
+        Endian endian = NativeEndian;
+        uint8_t raw = 0;            // 1 when the elements follow as one raw block of count * element_size bytes
+        uint32_t element_size = 0;
+        uint32_t user_version = 0;  // free for the caller's own schema versioning
+        uint64_t type_tag = 0;
+        uint64_t count = 0;
+    };
+
+    // Raw block format for trivially copyable types without an ElementSerializer specialization
+    template <typename T>
+    inline constexpr bool IsRawSerializableV = std::is_trivially_copyable_v<T> && requires { typename ElementSerializer<T>::IsDefault; };
+
+    // Arithmetic and enum elements can be byte-swapped when a block written on the other endianness is read
+    template <typename T>
+    inline constexpr bool IsByteSwappableV = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    template <typename T>
+    void ByteSwapN(T* first_, size_t n_) noexcept
+    {
+        for (; n_ > 0; --n_, ++first_)
+        {
+            unsigned char* bytes = reinterpret_cast<unsigned char*>(first_);
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+    }
+
+    //-------------------------------------------------------------------Sinks & Sources------------------------------------------------------
+
+    class FdSink
+    {
+    public:
+
+        explicit FdSink(int fd_) noexcept : fd(fd_) {}
+
+        void Write(const void* bytes_, size_t count_)
+        {
+            iovec part{ const_cast<void*>(bytes_), count_ };
+            WriteV(&part, 1);
+        }
+
+        // Writes every part, retrying on partial writes and EINTR
+        void WriteV(iovec* parts_, int count_)
+        {
+            while (count_ > 0)
+            {
+                const ssize_t written = ::writev(fd, parts_, count_);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "vector_io: writev");
+                }
+                size_t left = static_cast<size_t>(written);
+                for (; count_ > 0 && left >= parts_->iov_len; ++parts_, --count_)
+                {
+                    left -= parts_->iov_len;
+                }
+                if (count_ > 0)
+                {
+                    parts_->iov_base = static_cast<char*>(parts_->iov_base) + left;
+                    parts_->iov_len -= left;
+                }
+            }
+        }
+
+    private:
+
+        int fd;
+    };
+
+    class FdSource
+    {
+    public:
+
+        explicit FdSource(int fd_) noexcept : fd(fd_) {}
+
+        void Read(void* bytes_, size_t count_)
+        {
+            char* dest = static_cast<char*>(bytes_);
+            while (count_ > 0)
+            {
+                const ssize_t got = ::read(fd, dest, count_);
+                if (got < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "vector_io: read");
+                }
+                if (got == 0)
+                {
+                    throw std::runtime_error("vector_io: unexpected end of file");
+                }
+                dest += got;
+                count_ -= static_cast<size_t>(got);
+            }
+        }
+
+    private:
+
+        int fd;
+    };
+
+    class StreamSink
+    {
+    public:
+
+        explicit StreamSink(std::ostream& stream_) noexcept : stream(stream_) {}
+
+        void Write(const void* bytes_, size_t count_)
+        {
+            if (!stream.write(static_cast<const char*>(bytes_), static_cast<std::streamsize>(count_)))
+            {
+                throw std::runtime_error("vector_io: stream write failed");
+            }
+        }
+
+    private:
+
+        std::ostream& stream;
+    };
+
+    class StreamSource
+    {
+    public:
+
+        explicit StreamSource(std::istream& stream_) noexcept : stream(stream_) {}
+
+        void Read(void* bytes_, size_t count_)
+        {
+            if (!stream.read(static_cast<char*>(bytes_), static_cast<std::streamsize>(count_)))
+            {
+                throw std::runtime_error("vector_io: unexpected end of stream");
+            }
+        }
+
+    private:
+
+        std::istream& stream;
+    };
+
+    //---------------------------------------------------------------------Generic Format-----------------------------------------------------
+
+    template <typename T>
+    Header MakeHeader(size_t count_, uint32_t user_version_) noexcept
+    {
+        Header header;
+        header.raw = IsRawSerializableV<T> ? 1 : 0;
+        header.element_size = sizeof(T);
+        header.user_version = user_version_;
+        header.type_tag = SerializedTypeTag<T>::value;
+        header.count = count_;
+        return header;
+    }
+
+    template <typename T, typename Alloc, typename Growth, typename Sink>
+    void WriteElements(Sink& sink_, const Vector<T, Alloc, Growth>& vector_)
+    {
+        if constexpr (IsRawSerializableV<T>)
+        {
+            sink_.Write(vector_.Data(), vector_.Size() * sizeof(T));
+        }
+        else
+        {
+            for (const T& item : vector_)
+            {
+                ElementSerializer<T>::Write(sink_, item);
+            }
+        }
+    }
+
+    // A header written on the other byte order is swapped field by field before anything is checked
+    inline void NormalizeHeader(Header& header_) noexcept
+    {
+        if (header_.endian != NativeEndian)
+        {
+            ByteSwapN(&header_.magic, 1);
+            ByteSwapN(&header_.version, 1);
+            ByteSwapN(&header_.element_size, 1);
+            ByteSwapN(&header_.user_version, 1);
+            ByteSwapN(&header_.type_tag, 1);
+            ByteSwapN(&header_.count, 1);
+        }
+    }
+
+    template <typename T>
+    void CheckHeader(const Header& header_)
+    {
+        if (header_.magic != Header::Magic || header_.version != Header::CurrentVersion)
+        {
+            throw std::runtime_error("vector_io: not a serialized Vector or unsupported version");
+        }
+        if (header_.element_size != sizeof(T) || header_.type_tag != SerializedTypeTag<T>::value || header_.raw != (IsRawSerializableV<T> ? 1 : 0))
+        {
+            throw std::runtime_error("vector_io: serialized elements have a different type");
+        }
+        if (header_.endian != NativeEndian && !(IsRawSerializableV<T> && IsByteSwappableV<T>))
+        {
+            throw std::runtime_error("vector_io: block was written with a different byte order");
+        }
+        if (header_.count > std::numeric_limits<size_t>::max() / sizeof(T))
+        {
+            throw std::length_error("vector_io: element count overflows");
+        }
+    }
+
+    // Replaces the contents of vector_; raw blocks are read into freshly reserved capacity without value-initialization
+    template <typename T, typename Alloc, typename Growth, typename Source>
+    void ReadElements(Source& source_, const Header& header_, Vector<T, Alloc, Growth>& vector_)
+    {
+        const size_t count = static_cast<size_t>(header_.count);
+        vector_.ClearKeepingCapacity();
+        if (count > vector_.Capacity())
+        {
+            // Drop the old block first so the exact-size allocation below is the only one
+            vector_.ShrinkToFit();
+            vector_.Reserve(count);
+        }
+
+        if constexpr (IsRawSerializableV<T>)
+        {
+            vector_.ResizeAndOverwrite(count, [&](T* data_, size_t n_)
+            {
+                source_.Read(data_, n_ * sizeof(T));
+                if constexpr (IsByteSwappableV<T>)
+                {
+                    if (header_.endian != NativeEndian)
+                    {
+                        ByteSwapN(data_, n_);
+                    }
+                }
+                return n_;
+            });
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                vector_.EmplaceBack(ElementSerializer<T>::Read(source_));
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------Entry Points--------------------------------------------------------
+
+    // Writes the header and the raw block with a single writev (the header and every element through fd_ otherwise)
+    template <typename T, typename Alloc, typename Growth>
+    void WriteTo(int fd_, const Vector<T, Alloc, Growth>& vector_, uint32_t user_version_ = 0)
+    {
+        Header header = MakeHeader<T>(vector_.Size(), user_version_);
+        FdSink sink(fd_);
+        if constexpr (IsRawSerializableV<T>)
+        {
+            iovec parts[2] = {
+                { &header, sizeof(header) },
+                { const_cast<T*>(vector_.Data()), vector_.Size() * sizeof(T) }
+            };
+            sink.WriteV(parts, 2);
+        }
+        else
+        {
+            sink.Write(&header, sizeof(header));
+            WriteElements(sink, vector_);
+        }
+    }
+
+    template <typename T, typename Alloc, typename Growth>
+    void WriteTo(std::ostream& stream_, const Vector<T, Alloc, Growth>& vector_, uint32_t user_version_ = 0)
+    {
+        const Header header = MakeHeader<T>(vector_.Size(), user_version_);
+        StreamSink sink(stream_);
+        sink.Write(&header, sizeof(header));
+        WriteElements(sink, vector_);
+    }
+
+    // Spare room AppendFromFd makes sure of before reading, so a fresh vector does not start with one-element reads
+    inline constexpr size_t MinReadBytes = 4096;
+
+    // Reads up to max_count_ elements from fd_ straight into the vector's spare capacity (grown with its growth policy when
+    // less than MinReadBytes is spare) and commits them. One read is issued, plus as many as it takes to finish an element split across reads.
+    // Returns the number of elements appended: 0 at end of file, or when a non-blocking fd_ has nothing to offer
+    template <typename T, typename Alloc, typename Growth> requires std::is_trivially_copyable_v<T>
+    size_t AppendFromFd(int fd_, Vector<T, Alloc, Growth>& vector_, size_t max_count_ = std::numeric_limits<size_t>::max())
+    {
+        if (max_count_ == 0)
+        {
+            return 0;
+        }
+        const std::span<T> spare = vector_.SpareCapacity(std::min(max_count_, std::max<size_t>(1, MinReadBytes / sizeof(T))));
+        const size_t wanted = std::min(spare.size(), max_count_) * sizeof(T);
+        char* dest = reinterpret_cast<char*>(spare.data());
+        size_t got = 0;
+        // An interrupted read is re-issued; the loop ends only at end of file or on an element boundary after some data
+        for (;;)
+        {
+            const ssize_t result = ::read(fd_, dest + got, wanted - got);
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if ((errno == EAGAIN || errno == EWOULDBLOCK) && got % sizeof(T) != 0)
+                {
+                    // Half an element is in the buffer already; wait for the rest instead of spinning
+                    pollfd readable{ fd_, POLLIN, 0 };
+                    ::poll(&readable, 1, -1);
+                    continue;
+                }
+                if ((errno == EAGAIN || errno == EWOULDBLOCK) && got == 0)
+                {
+                    return 0;
+                }
+                throw std::system_error(errno, std::generic_category(), "vector_io: read");
+            }
+            if (result == 0)
+            {
+                if (got % sizeof(T) != 0)
+                {
+                    throw std::runtime_error("vector_io: end of file inside an element");
+                }
+                break;
+            }
+            got += static_cast<size_t>(result);
+            if (got % sizeof(T) == 0)
+            {
+                break;
+            }
+        }
+
+        vector_.CommitSize(got / sizeof(T));
+        return got / sizeof(T);
+    }
+
+    // Appends everything up to end of file. Returns the number of elements appended
+    template <typename T, typename Alloc, typename Growth> requires std::is_trivially_copyable_v<T>
+    size_t AppendAllFromFd(int fd_, Vector<T, Alloc, Growth>& vector_)
+    {
+        size_t total = 0;
+        while (const size_t appended = AppendFromFd(fd_, vector_))
+        {
+            total += appended;
+        }
+        return total;
+    }
+
+    // Returns the header, so the caller can inspect user_version
+    template <typename T, typename Alloc, typename Growth>
+    Header ReadFrom(int fd_, Vector<T, Alloc, Growth>& vector_)
+    {
+        FdSource source(fd_);
+        Header header;
+        source.Read(&header, sizeof(header));
+        NormalizeHeader(header);
+        CheckHeader<T>(header);
+        ReadElements(source, header, vector_);
+        return header;
+    }
+
+    template <typename T, typename Alloc, typename Growth>
+    Header ReadFrom(std::istream& stream_, Vector<T, Alloc, Growth>& vector_)
+    {
+        StreamSource source(stream_);
+        Header header;
+        source.Read(&header, sizeof(header));
+        NormalizeHeader(header);
+        CheckHeader<T>(header);
+        ReadElements(source, header, vector_);
+        return header;
+    }
+}
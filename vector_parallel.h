@@ -0,0 +1,286 @@
+#pragma once
+// Executors for Vector's parallel bulk operations. Anything with Run(task_count_, task_) that calls task_(i) once for
+// every i in [0, task_count_) and returns when all calls are done can be used, e.g. a thin adapter over an existing
+// thread pool. Define VECTOR_ENABLE_EXECUTION_POLICIES to also accept standard execution policies (std::execution::par, ...)
+// directly; it pulls in <execution>, which with libstdc++ means linking the TBB backend (-ltbb).
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(VECTOR_ENABLE_EXECUTION_POLICIES)
+#include <execution>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace vector_parallel
+{
+    // Work is split into chunks of about this many bytes, so each task streams through an L2-sized block
+    inline constexpr size_t ChunkBytes = size_t(256) << 10;
+
+    template <typename T>
+    constexpr size_t ChunkElements() noexcept
+    {
+        return std::max<size_t>(1, ChunkBytes / sizeof(T));
+    }
+
+    struct TaskProbe
+    {
+        void operator()(size_t) const noexcept {}
+    };
+
+    template <typename E>
+    concept Executor = requires(E& executor_, size_t task_count_, TaskProbe task_)
+    {
+        executor_.Run(task_count_, task_);
+    };
+
+    // Runs the tasks on up to Threads() std::threads, the calling thread included; tasks are handed out one at a time
+    class ThreadExecutor
+    {
+    public:
+
+        explicit ThreadExecutor(size_t threads_ = std::thread::hardware_concurrency()) noexcept : threads(std::max<size_t>(1, threads_)) {}
+
+        size_t Threads() const noexcept
+        {
+            return threads;
+        }
+
+        template <typename Task>
+        void Run(size_t task_count_, Task&& task_) const
+        {
+            if (task_count_ == 0)
+            {
+                return;
+            }
+            std::atomic<size_t> next{ 0 };
+            auto work = [&]()
+            {
+                for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < task_count_; i = next.fetch_add(1, std::memory_order_relaxed))
+                {
+                    task_(i);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(std::min(threads, task_count_) - 1);
+            for (size_t i = 1; i < std::min(threads, task_count_); ++i)
+            {
+                workers.emplace_back(work);
+            }
+            work();
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+    private:
+
+        size_t threads;
+    };
+
+    // Splits the tasks into Threads() contiguous blocks and always runs block k on worker k, optionally pinned to the k-th
+    // CPU the process may use. Because the assignment is fixed, a first-touch initialization (Vector's parallel
+    // constructor, Resize(size_, executor_)) and every later ForEachChunk pass over the same count with the same executor
+    // touch each page from the same worker, so with pinning the pages stay on that worker's NUMA node
+    class StaticThreadExecutor
+    {
+    public:
+
+        explicit StaticThreadExecutor(size_t threads_ = std::thread::hardware_concurrency(), [[maybe_unused]] bool pin_ = false)
+            : threads(std::max<size_t>(1, threads_))
+        {
+#if defined(__linux__)
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if (pin_ && sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+            {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                {
+                    if (CPU_ISSET(cpu, &allowed))
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+            }
+#endif
+        }
+
+        size_t Threads() const noexcept
+        {
+            return threads;
+        }
+
+        template <typename Task>
+        void Run(size_t task_count_, Task&& task_) const
+        {
+            if (task_count_ == 0)
+            {
+                return;
+            }
+            // Block k is [k * task_count_ / threads, (k + 1) * task_count_ / threads)
+            auto block = [&](size_t k_)
+            {
+                Pin(k_);
+                for (size_t i = k_ * task_count_ / threads; i < (k_ + 1) * task_count_ / threads; ++i)
+                {
+                    task_(i);
+                }
+            };
+
+            // A pinned run leaves the calling thread's affinity alone, so every block gets a thread of its own
+            const size_t first_spawned = cpus.empty() ? 1 : 0;
+            std::vector<std::thread> workers;
+            workers.reserve(threads - first_spawned);
+            for (size_t k = first_spawned; k < threads; ++k)
+            {
+                if (k * task_count_ / threads != (k + 1) * task_count_ / threads)
+                {
+                    workers.emplace_back(block, k);
+                }
+            }
+            if (first_spawned == 1)
+            {
+                block(0);
+            }
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+    private:
+
+        size_t threads;
+        std::vector<int> cpus;
+
+        // Called on the worker itself before it runs any task, so none of its first touches happen elsewhere
+        void Pin([[maybe_unused]] size_t k_) const noexcept
+        {
+#if defined(__linux__)
+            if (!cpus.empty())
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpus[k_ % cpus.size()], &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            }
+#endif
+        }
+    };
+
+#if defined(VECTOR_ENABLE_EXECUTION_POLICIES)
+    template <typename T>
+    inline constexpr bool IsExecutionPolicyV = std::is_execution_policy_v<std::remove_cvref_t<T>>;
+
+    // Adapts a standard execution policy; the algorithms want forward iterators, so the task indices are materialized
+    template <typename Policy>
+    class PolicyExecutor
+    {
+    public:
+
+        explicit PolicyExecutor(const Policy& policy_) noexcept : policy(policy_) {}
+
+        template <typename Task>
+        void Run(size_t task_count_, Task&& task_) const
+        {
+            std::vector<size_t> indices(task_count_);
+            std::iota(indices.begin(), indices.end(), size_t(0));
+            std::for_each(policy, indices.begin(), indices.end(), [&task_](size_t i_) { task_(i_); });
+        }
+
+    private:
+
+        const Policy& policy;
+    };
+#else
+    template <typename T>
+    inline constexpr bool IsExecutionPolicyV = false;
+#endif
+
+    template <typename E>
+    concept ExecutorLike = Executor<std::remove_cvref_t<E>> || IsExecutionPolicyV<E>;
+
+    template <ExecutorLike E>
+    decltype(auto) AsExecutor(E& executor_)
+    {
+#if defined(VECTOR_ENABLE_EXECUTION_POLICIES)
+        if constexpr (IsExecutionPolicyV<E>)
+        {
+            return PolicyExecutor<std::remove_cvref_t<E>>(executor_);
+        }
+        else
+#endif
+        {
+            return (executor_);
+        }
+    }
+
+    // Calls task_(i) for every i in [0, task_count_) on executor_. Once a task throws, the tasks not yet started are
+    // skipped and the first exception is rethrown on the calling thread
+    template <ExecutorLike E, typename Task>
+    void ParallelFor(E& executor_, size_t task_count_, Task&& task_)
+    {
+        std::mutex mutex;
+        std::exception_ptr error;
+        std::atomic<bool> failed{ false };
+
+        auto guarded = [&](size_t i_) noexcept
+        {
+            if (failed.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            try
+            {
+                task_(i_);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        };
+
+        if (task_count_ == 1)
+        {
+            guarded(0);
+        }
+        else if (task_count_ > 1)
+        {
+            AsExecutor(executor_).Run(task_count_, guarded);
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Chunked form of ParallelFor over count_ elements: chunk_(first_, n_) handles [first_, first_ + n_)
+    template <typename T, ExecutorLike E, typename Chunk>
+    void ForEachChunk(E& executor_, size_t count_, Chunk&& chunk_)
+    {
+        const size_t chunk = ChunkElements<T>();
+        ParallelFor(executor_, (count_ + chunk - 1) / chunk, [&](size_t i_)
+        {
+            const size_t first = i_ * chunk;
+            chunk_(first, std::min(chunk, count_ - first));
+        });
+    }
+}